@@ -15,10 +15,19 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <assert.h>
+#include <errno.h>
+#include <unistd.h>
 #include "segments.h"
 #include "instructions.h"
 
+#define OUTPUT_BUFFER_SIZE 65536
+
+static unsigned char output_buffer[OUTPUT_BUFFER_SIZE];
+static size_t output_length = 0;
+static bool output_line_flush = false;
+
 static inline uint32_t shr(uint32_t word, unsigned bits)
 {
         if (bits == 32) {
@@ -207,7 +216,48 @@ void bit_NAND(uint32_t* regA, uint32_t regB, uint32_t regC)
 }
 
 /**********************************************************************
- * Description: Writes the value in regC to the I/O device immediately.
+ * Description: Decides whether output is flushed at every newline, which
+ *              is only wanted when stdout is a terminal.
+ *
+ * Parameters: None
+ *
+ * Expects: Called before the first output.
+ **********************************************************************/
+void output_init(void)
+{
+        output_line_flush = isatty(STDOUT_FILENO);
+}
+
+/**********************************************************************
+ * Description: Writes everything buffered by output to the I/O device.
+ *
+ * Parameters: None
+ *
+ * Expects: None
+ *
+ * Notes:
+ *      Called when the buffer fills, before every input, and at HALT.
+ **********************************************************************/
+void output_flush(void)
+{
+        size_t written = 0;
+        while (written < output_length) {
+                ssize_t n = write(STDOUT_FILENO, output_buffer + written,
+                                  output_length - written);
+                if (n < 0 && errno == EINTR) {
+                        continue;
+                }
+                if (n <= 0) {
+                        break;
+                }
+                written += n;
+        }
+        output_length = 0;
+}
+
+/**********************************************************************
+ * Description: Writes the value in regC to the I/O device. Bytes are
+ *              buffered and reach the device at the next output_flush.
  *              Only values from 0 to 255 are allowed.
  *
  * Parameters:
@@ -220,7 +270,11 @@ void bit_NAND(uint32_t* regA, uint32_t regB, uint32_t regC)
  **********************************************************************/
 void output(uint32_t regC)
 {
-        printf("%c", regC);
+        output_buffer[output_length++] = regC;
+        if (output_length == OUTPUT_BUFFER_SIZE ||
+            (regC == '\n' && output_line_flush)) {
+                output_flush();
+        }
 }
 
 /**********************************************************************
@@ -236,10 +290,12 @@ void output(uint32_t regC)
  *
  * Notes:
  *      Waits for input on the I/O device and stores the input in regC.
+ *      Pending output is flushed first so prompts are visible.
  *      Will CRE if regC is NULL.
  **********************************************************************/
 void input(uint32_t* regC)
 {
+        output_flush();
         uint32_t input = getchar();
         
         if (input <= 255) {
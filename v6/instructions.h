@@ -36,6 +36,10 @@ void divide(uint32_t* regA, uint32_t regB, uint32_t regC);
 
 void bit_NAND(uint32_t* regA, uint32_t regB, uint32_t regC);
 
+void output_init(void);
+
+void output_flush(void);
+
 void output(uint32_t regC);
 
 void input(uint32_t* regC);
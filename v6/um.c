@@ -70,6 +70,7 @@ int main(int argc, char *argv[])
 
         uint32_t registers[8] = {0, 0, 0, 0, 0, 0, 0, 0};
         uint32_t prog_counter = 0;
+        output_init();
         bool halted = false;
 
         /* iterate through instructions until a halt is read */
@@ -141,6 +142,7 @@ int main(int argc, char *argv[])
                 }
         }
 
+        output_flush();
         fclose(inputFile);
         segment_deinit(segments);
 
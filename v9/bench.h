@@ -0,0 +1,39 @@
+/**************************************************************
+ *                        bench.h
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   Helpers shared by the bench_* programs: encoding
+ *                  UM instruction words for small synthetic programs,
+ *                  and a monotonic clock.
+ *
+ **************************************************************/
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include <time.h>
+#include "instructions.h"
+
+static inline uint32_t um_op(opcode op, unsigned a, unsigned b, unsigned c)
+{
+        return ((uint32_t)op << 28) | (a << 6) | (b << 3) | c;
+}
+
+static inline uint32_t um_loadv(unsigned a, uint32_t value)
+{
+        return ((uint32_t)LOADV << 28) | (a << 25) |
+               (value & LOADVAL_VALUE_MASK);
+}
+
+static inline double bench_seconds(void)
+{
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+#endif
@@ -0,0 +1,350 @@
+/**************************************************************
+ *                        bench_gen.c
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   Writes microbenchmark images that each stress one
+ *                  kind of instruction, for timing any engine per
+ *                  opcode class:
+ *
+ *                      ./bench_gen [-n instructions] [-u unroll]
+ *                                  [-s segment_words] [-m map_words]
+ *                                  [-l program_words] dir
+ *
+ *                  Every image is an outer loop around an inner loop
+ *                  around 'unroll' copies of its body, and runs about
+ *                  'instructions' instructions (100M by default); the
+ *                  exact count is worked out as the image is written,
+ *                  then checked by running it on the v9 core. One line
+ *                  per image goes to stdout: name, file, instructions
+ *                  before HALT, and how many of those are the stressed
+ *                  opcode. The "loop" image is the bare loop, whose
+ *                  cost the others include.
+ *
+ *                  sload/sstore walk a segment of 'segment_words'
+ *                  words, map maps and unmaps segments of 'map_words',
+ *                  jump chains LOADPs within segment 0, and loadp loads
+ *                  a copy of its own 'program_words'-word program with
+ *                  every LOADP (sized by words copied, not by
+ *                  instructions).
+ *
+ **************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include "segments.h"
+#include "execute.h"
+#include "bench.h"
+
+/**************************************************************
+ * The Image struct consists of:
+ *      - words/length/capacity: the program so far.
+ *      - weight: how many times the next word emitted will run.
+ *      - instructions: how many times the words so far run.
+ *      - stressed: how many of those are the image's opcode.
+ *************************************************************/
+typedef struct {
+        uint32_t* words;
+        uint32_t length;
+        uint32_t capacity;
+        uint64_t weight;
+        uint64_t instructions;
+        uint64_t stressed;
+} Image;
+
+typedef struct {
+        uint32_t head;
+        unsigned counter;
+        uint32_t count;
+} Loop;
+
+typedef struct {
+        uint64_t instructions;
+        uint32_t unroll;
+        uint32_t segment_words;
+        uint32_t map_words;
+        uint32_t program_words;
+} Params;
+
+static uint32_t emit(Image* im, uint32_t word)
+{
+        if (im->length == im->capacity) {
+                im->capacity = im->capacity == 0 ? 256 : 2 * im->capacity;
+                im->words = realloc(im->words,
+                                    sizeof(uint32_t) * im->capacity);
+        }
+        im->words[im->length] = word;
+        im->instructions += im->weight;
+        return im->length++;
+}
+
+/* a word of the opcode being measured */
+static void stress(Image* im, uint32_t word)
+{
+        emit(im, word);
+        im->stressed += im->weight;
+}
+
+/* runs what follows 'count' times, counting register 'counter' down;
+ * r1 and r7 are overwritten at the end of each pass */
+static Loop loop_begin(Image* im, unsigned counter, uint32_t count)
+{
+        emit(im, um_loadv(counter, count));
+        im->weight *= count;
+        return (Loop){ im->length, counter, count };
+}
+
+/* r4 holds -1: back to the head unless the counter reached 0 */
+static void loop_end(Image* im, Loop loop)
+{
+        emit(im, um_loadv(1, loop.head));
+        emit(im, um_op(ADD, loop.counter, loop.counter, 4));
+        emit(im, um_loadv(7, im->length + 3));
+        emit(im, um_op(CMOV, 7, 1, loop.counter));
+        emit(im, um_op(LOADP, 0, 0, 7));
+        im->weight /= loop.count;
+}
+
+/* the classes: each sets up registers, then gives its body and inner
+ * pass count. r0 is 0, r4 is -1; r5 and r6 are the loop counters. */
+static const char* const classes[] = {
+        "loop", "add", "nand", "mult", "div", "cmov", "sload", "sstore",
+        "map", "jump", "loadp"
+};
+
+#define NUM_CLASSES (sizeof(classes) / sizeof(classes[0]))
+#define MAX_COUNT LOADVAL_VALUE_MASK
+
+static void body(Image* im, const char* name, Params p)
+{
+        for (uint32_t i = 0; i < p.unroll; i++) {
+                if (strcmp(name, "add") == 0) {
+                        stress(im, um_op(ADD, 1, 1, 3));
+                } else if (strcmp(name, "nand") == 0) {
+                        stress(im, um_op(NAND, 1, 1, 3));
+                } else if (strcmp(name, "mult") == 0) {
+                        stress(im, um_op(MULT, 1, 1, 3));
+                } else if (strcmp(name, "div") == 0) {
+                        stress(im, um_op(DIV, 1, 2, 3));
+                } else if (strcmp(name, "cmov") == 0) {
+                        stress(im, um_op(CMOV, 1, 3, 3));
+                } else if (strcmp(name, "sload") == 0) {
+                        stress(im, um_op(SLOAD, 1, 2, 3));
+                        emit(im, um_op(ADD, 3, 3, 4));
+                } else if (strcmp(name, "sstore") == 0) {
+                        stress(im, um_op(SSTORE, 2, 3, 1));
+                        emit(im, um_op(ADD, 3, 3, 4));
+                } else if (strcmp(name, "map") == 0) {
+                        stress(im, um_op(MAP, 0, 2, 3));
+                        stress(im, um_op(UNMAP, 0, 0, 2));
+                } else if (strcmp(name, "jump") == 0) {
+                        emit(im, um_loadv(7, im->length + 2));
+                        stress(im, um_op(LOADP, 0, 0, 7));
+                } else if (strcmp(name, "loadp") == 0) {
+                        emit(im, um_loadv(7, im->length + 2));
+                        stress(im, um_op(LOADP, 0, 2, 7));
+                }
+        }
+}
+
+/* 'name' with program_words as its length if it is loadp; false if it
+ * doesn't fit the parameters */
+static bool generate(Image* im, const char* name, Params p)
+{
+        bool walks = strcmp(name, "sload") == 0 ||
+                     strcmp(name, "sstore") == 0;
+        *im = (Image){ .weight = 1 };
+        emit(im, um_op(NAND, 4, 0, 0));
+        if (walks) {
+                emit(im, um_loadv(3, p.segment_words));
+                emit(im, um_op(MAP, 0, 2, 3));
+        } else if (strcmp(name, "map") == 0) {
+                emit(im, um_loadv(3, p.map_words));
+        } else if (strcmp(name, "div") == 0) {
+                emit(im, um_loadv(2, MAX_COUNT));
+                emit(im, um_loadv(3, 3));
+        } else if (strcmp(name, "mult") == 0) {
+                emit(im, um_loadv(3, 3));
+        } else {
+                emit(im, um_loadv(3, 1));
+        }
+        if (strcmp(name, "loadp") == 0) {
+                /* a copy of this program in r2, written word by word */
+                emit(im, um_loadv(3, p.program_words));
+                emit(im, um_op(MAP, 0, 2, 3));
+                emit(im, um_loadv(3, p.program_words - 1));
+                Loop copy = loop_begin(im, 5, p.program_words);
+                emit(im, um_op(SLOAD, 1, 0, 3));
+                emit(im, um_op(SSTORE, 2, 3, 1));
+                emit(im, um_op(ADD, 3, 3, 4));
+                loop_end(im, copy);
+        }
+
+        /* instructions per inner pass: the body and the loop's five;
+         * a program load counts as a word's worth per word copied */
+        uint64_t per_pass = (walks ? 2 : strcmp(name, "map") == 0 ||
+                             strcmp(name, "jump") == 0 ||
+                             strcmp(name, "loadp") == 0 ? 2 :
+                             strcmp(name, "loop") == 0 ? 0 : 1) *
+                            (uint64_t)p.unroll + 5;
+        if (strcmp(name, "loadp") == 0) {
+                per_pass += (uint64_t)p.unroll * p.program_words;
+        }
+        uint64_t inner = walks ? p.segment_words / p.unroll :
+                         p.instructions / per_pass;
+        if (inner > (1u << 20) && !walks) {
+                inner = 1u << 20;
+        }
+        if (inner == 0) {
+                inner = 1;
+        }
+        uint64_t outer = p.instructions / (inner * per_pass);
+        if (outer == 0) {
+                outer = 1;
+        }
+        if (outer > MAX_COUNT) {
+                return false;
+        }
+
+        Loop outer_loop = loop_begin(im, 6, outer);
+        if (walks) {
+                emit(im, um_loadv(3, p.segment_words - 1));
+        }
+        Loop inner_loop = loop_begin(im, 5, inner);
+        body(im, strcmp(name, "loop") == 0 ? "" : name, p);
+        loop_end(im, inner_loop);
+        loop_end(im, outer_loop);
+
+        /* HALT isn't counted, as um_instructions doesn't */
+        im->weight = 0;
+        emit(im, um_op(HALT, 0, 0, 0));
+        if (strcmp(name, "loadp") == 0) {
+                if (im->length > p.program_words) {
+                        return false;
+                }
+                while (im->length < p.program_words) {
+                        emit(im, 0);
+                }
+        }
+        return true;
+}
+
+/* runs the image on the v9 core; instructions, and seconds taken */
+static uint64_t run(Image* im, double* seconds)
+{
+        Segment_T segments = segment_init(im->length);
+        for (uint32_t i = 0; i < im->length; i++) {
+                segments->mapped[0][i] = im->words[i];
+        }
+        decode_program(segments);
+        segments->io = io_new_fd(STDIN_FILENO, STDOUT_FILENO);
+
+        uint32_t registers[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        uint32_t pc = 0;
+        uint64_t steps = 0;
+        double start = bench_seconds();
+        Exec_status status = execute_for(segments, registers, &pc, &steps,
+                                         UINT64_MAX);
+        *seconds = bench_seconds() - start;
+        segment_deinit(segments);
+        return status == EXEC_HALTED ? steps : 0;
+}
+
+static bool write_image(Image* im, const char* path)
+{
+        FILE* file = fopen(path, "wb");
+        if (file == NULL) {
+                return false;
+        }
+        for (uint32_t i = 0; i < im->length; i++) {
+                uint32_t w = im->words[i];
+                unsigned char bytes[4] = { w >> 24, w >> 16, w >> 8, w };
+                fwrite(bytes, 1, 4, file);
+        }
+        return fclose(file) == 0;
+}
+
+static void usage(const char* name)
+{
+        fprintf(stderr, "usage: %s [-n instructions] [-u unroll] "
+                "[-s segment_words] [-m map_words] [-l program_words] "
+                "dir\n", name);
+        exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[])
+{
+        Params p = { 100000000, 16, 1u << 20, 8, 1024 };
+        int opt;
+        while ((opt = getopt(argc, argv, "n:u:s:m:l:")) != -1) {
+                uint64_t value = strtoull(optarg, NULL, 0);
+                switch (opt) {
+                case 'n':
+                        p.instructions = value;
+                        break;
+                case 'u':
+                        p.unroll = value;
+                        break;
+                case 's':
+                        p.segment_words = value;
+                        break;
+                case 'm':
+                        p.map_words = value;
+                        break;
+                case 'l':
+                        p.program_words = value;
+                        break;
+                default:
+                        usage(argv[0]);
+                }
+        }
+        if (optind != argc - 1 || p.unroll < 1 || p.unroll > 1024 ||
+            p.segment_words < p.unroll || p.segment_words > MAX_COUNT ||
+            p.map_words > MAX_COUNT || p.program_words < 2 ||
+            p.program_words > MAX_COUNT) {
+                usage(argv[0]);
+        }
+        /* whole passes over the segment */
+        p.segment_words -= p.segment_words % p.unroll;
+
+        bool all_right = true;
+        for (size_t c = 0; c < NUM_CLASSES; c++) {
+                Image im;
+                if (!generate(&im, classes[c], p)) {
+                        fprintf(stderr, "%s: parameters out of range for "
+                                "%s\n", argv[0], classes[c]);
+                        return EXIT_FAILURE;
+                }
+                char path[4096];
+                snprintf(path, sizeof(path), "%s/%s.um", argv[optind],
+                         classes[c]);
+                if (!write_image(&im, path)) {
+                        perror(path);
+                        return EXIT_FAILURE;
+                }
+
+                double seconds;
+                uint64_t ran = run(&im, &seconds);
+                if (ran != im.instructions) {
+                        fprintf(stderr, "%s: ran %llu instructions, not "
+                                "%llu\n", path, (unsigned long long)ran,
+                                (unsigned long long)im.instructions);
+                        all_right = false;
+                }
+                printf("%-7s %s %llu %llu\n", classes[c], path,
+                       (unsigned long long)im.instructions,
+                       (unsigned long long)im.stressed);
+                fflush(stdout);
+                fprintf(stderr, "%-7s %6.2f ns per instruction on the v9 "
+                        "core\n", classes[c],
+                        seconds * 1e9 / im.instructions);
+                free(im.words);
+        }
+        return all_right ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,87 @@
+/**************************************************************
+ *                        bench_input.c
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   INPUT throughput. A child process writes 'bytes'
+ *                  (default 2GB) into a pipe that becomes stdin for a
+ *                  UM program, cat.um by default, and the rate is
+ *                  reported on stderr, so redirect stdout:
+ *
+ *                      ./bench_input [bytes [program.um]] > /dev/null
+ *
+ **************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include "segments.h"
+#include "execute.h"
+#include "load.h"
+#include "bench.h"
+
+/* write 'bytes' of text to 'fd' */
+static void produce(int fd, uint64_t bytes)
+{
+        static char chunk[65536];
+        for (size_t i = 0; i < sizeof(chunk); i++) {
+                chunk[i] = i % 64 == 63 ? '\n' : 'a' + i % 26;
+        }
+
+        while (bytes > 0) {
+                size_t len = bytes < sizeof(chunk) ? bytes : sizeof(chunk);
+                ssize_t n = write(fd, chunk, len);
+                if (n <= 0) {
+                        return;
+                }
+                bytes -= n;
+        }
+}
+
+int main(int argc, char *argv[])
+{
+        uint64_t bytes = argc > 1 ? strtoull(argv[1], NULL, 0) : 2ull << 30;
+        const char* path = argc > 2 ? argv[2] : "../umbin/cat.um";
+
+        Segment_T segments = load_program(path);
+        if (segments == NULL) {
+                fprintf(stderr, "%s: No such file or directory\n", path);
+                return EXIT_FAILURE;
+        }
+
+        int fds[2];
+        if (pipe(fds) != 0) {
+                perror("pipe");
+                return EXIT_FAILURE;
+        }
+        pid_t child = fork();
+        if (child == 0) {
+                close(fds[0]);
+                produce(fds[1], bytes);
+                _exit(EXIT_SUCCESS);
+        }
+        close(fds[1]);
+        dup2(fds[0], STDIN_FILENO);
+        close(fds[0]);
+
+        uint32_t registers[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        segments->io = io_new_fd(STDIN_FILENO, STDOUT_FILENO);
+        double start = bench_seconds();
+        execute(segments, registers, 0);
+        double elapsed = bench_seconds() - start;
+
+        kill(child, SIGTERM);
+        waitpid(child, NULL, 0);
+        segment_deinit(segments);
+
+        fprintf(stderr, "input: %llu bytes through %s in %.3f s, "
+                "%.1f MB/s\n", (unsigned long long)bytes, path, elapsed,
+                bytes / elapsed / 1e6);
+        return EXIT_SUCCESS;
+}
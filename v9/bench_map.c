@@ -0,0 +1,107 @@
+/**************************************************************
+ *                        bench_map.c
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   MAP/UNMAP throughput. Runs two synthetic programs
+ *                  and reports on stderr:
+ *
+ *                      ./bench_map [maps [words [live]]]
+ *
+ *                  churn maps two 'words'-word segments and unmaps
+ *                  both, 'maps' MAPs in all, so IDs and storage are
+ *                  reused at once; grow maps 'live' segments and never
+ *                  unmaps them, so the ID tables have to grow (0 skips
+ *                  it).
+ *
+ **************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include "segments.h"
+#include "execute.h"
+#include "bench.h"
+
+#define UNROLL 8
+
+/* runs 'n' words of 'code' on a fresh machine; seconds taken */
+static double run(const uint32_t* code, uint32_t n)
+{
+        Segment_T segments = segment_init(n);
+        for (uint32_t i = 0; i < n; i++) {
+                segments->mapped[0][i] = code[i];
+        }
+        decode_program(segments);
+
+        uint32_t registers[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        segments->io = io_new_fd(STDIN_FILENO, STDOUT_FILENO);
+        double start = bench_seconds();
+        execute(segments, registers, 0);
+        double elapsed = bench_seconds() - start;
+        segment_deinit(segments);
+        return elapsed;
+}
+
+/* r0 = 0, r1 = iterations left, r2 = words, r4 = -1, r5 = loop,
+ * r7 = branch target (loop or done); 'unmap' pairs every two MAPs,
+ * into r3 and r6, with their UNMAPs */
+static uint32_t map_loop(uint32_t* code, uint32_t iterations,
+                         uint32_t words, bool unmap)
+{
+        uint32_t n = 0;
+        code[n++] = um_loadv(1, iterations);
+        code[n++] = um_loadv(2, words);
+        code[n++] = um_op(NAND, 4, 0, 0);
+        uint32_t loop = n + 1;
+        code[n++] = um_loadv(5, loop);
+        for (int i = 0; i < UNROLL; i += 2) {
+                code[n++] = um_op(MAP, 0, 3, 2);
+                code[n++] = um_op(MAP, 0, 6, 2);
+                if (unmap) {
+                        code[n++] = um_op(UNMAP, 0, 0, 3);
+                        code[n++] = um_op(UNMAP, 0, 0, 6);
+                }
+        }
+        code[n++] = um_op(ADD, 1, 1, 4);
+        uint32_t done = n + 3;
+        code[n++] = um_loadv(7, done);
+        code[n++] = um_op(CMOV, 7, 5, 1);
+        code[n++] = um_op(LOADP, 0, 0, 7);
+        code[n++] = um_op(HALT, 0, 0, 0);
+        return n;
+}
+
+int main(int argc, char *argv[])
+{
+        uint32_t iterations = (argc > 1 ? strtoul(argv[1], NULL, 0) :
+                               32u << 20) / UNROLL;
+        uint32_t words = argc > 2 ? strtoul(argv[2], NULL, 0) : 8;
+        uint32_t live = (argc > 3 ? strtoul(argv[3], NULL, 0) :
+                         1u << 20) / UNROLL;
+        if (iterations == 0 || iterations > LOADVAL_VALUE_MASK ||
+            words > LOADVAL_VALUE_MASK || live > LOADVAL_VALUE_MASK) {
+                fprintf(stderr, "%s: count out of range\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+
+        uint32_t code[64];
+        double maps = (double)iterations * UNROLL;
+        double elapsed = run(code, map_loop(code, iterations, words, true));
+        fprintf(stderr, "churn: %.0f MAP/UNMAP pairs of %u words in "
+                "%.3f s, %.1f ns per pair\n", maps / 2, words, elapsed,
+                elapsed * 1e9 / (maps / 2));
+
+        if (live > 0) {
+                maps = (double)live * UNROLL;
+                elapsed = run(code, map_loop(code, live, words, false));
+                fprintf(stderr, "grow:  %.0f MAPs of %u words kept in "
+                        "%.3f s, %.1f ns per MAP\n", maps, words, elapsed,
+                        elapsed * 1e9 / maps);
+        }
+        return EXIT_SUCCESS;
+}
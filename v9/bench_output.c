@@ -0,0 +1,71 @@
+/**************************************************************
+ *                        bench_output.c
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   OUTPUT throughput. Runs a synthetic program that
+ *                  prints a byte eight times per loop iteration and
+ *                  reports bytes/s on stderr, so redirect stdout:
+ *
+ *                      ./bench_output [bytes] > /dev/null
+ *
+ **************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include "segments.h"
+#include "execute.h"
+#include "bench.h"
+
+#define UNROLL 8
+
+int main(int argc, char *argv[])
+{
+        uint32_t iterations = (argc > 1 ? strtoul(argv[1], NULL, 0) :
+                               64u << 20) / UNROLL;
+        if (iterations == 0 || iterations > LOADVAL_VALUE_MASK) {
+                fprintf(stderr, "%s: byte count out of range\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+
+        /* r0 = 0, r1 = iterations left, r2 = byte, r4 = -1,
+         * r5 = loop, r7 = branch target (loop or done) */
+        uint32_t code[32];
+        uint32_t n = 0;
+        code[n++] = um_loadv(1, iterations);
+        code[n++] = um_loadv(2, 'u');
+        code[n++] = um_op(NAND, 4, 0, 0);
+        uint32_t loop = n + 1;
+        code[n++] = um_loadv(5, loop);
+        for (int i = 0; i < UNROLL; i++) {
+                code[n++] = um_op(OUTPUT, 0, 0, 2);
+        }
+        code[n++] = um_op(ADD, 1, 1, 4);
+        uint32_t done = n + 3;
+        code[n++] = um_loadv(7, done);
+        code[n++] = um_op(CMOV, 7, 5, 1);
+        code[n++] = um_op(LOADP, 0, 0, 7);
+        code[n++] = um_op(HALT, 0, 0, 0);
+
+        Segment_T segments = segment_init(n);
+        for (uint32_t i = 0; i < n; i++) {
+                segments->mapped[0][i] = code[i];
+        }
+        decode_program(segments);
+
+        uint32_t registers[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        segments->io = io_new_fd(STDIN_FILENO, STDOUT_FILENO);
+        double start = bench_seconds();
+        execute(segments, registers, 0);
+        double elapsed = bench_seconds() - start;
+        segment_deinit(segments);
+
+        double bytes = (double)iterations * UNROLL;
+        fprintf(stderr, "output: %.0f bytes in %.3f s, %.1f MB/s\n",
+                bytes, elapsed, bytes / elapsed / 1e6);
+        return EXIT_SUCCESS;
+}
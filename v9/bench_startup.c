@@ -0,0 +1,106 @@
+/**************************************************************
+ *                        bench_startup.c
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   Startup latency: time from file name to a decoded
+ *                  segment 0 for every .um/.umz in a directory
+ *                  (../umbin by default), with load_program and with
+ *                  the old word-at-a-time fread loop. Best of 'runs':
+ *
+ *                      ./bench_startup [dir [runs]]
+ *
+ **************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "segments.h"
+#include "load.h"
+#include "bench.h"
+
+/* the loader um.c used before load_program */
+static Segment_T fread_program(const char* path)
+{
+        FILE* inputFile = fopen(path, "rb");
+        if (inputFile == NULL) {
+                return NULL;
+        }
+        struct stat fileStat;
+        fstat(fileno(inputFile), &fileStat);
+
+        Segment_T segments = segment_init(fileStat.st_size / 4);
+        uint32_t word = 0;
+        uint32_t i = 0;
+        while (fread(&word, sizeof(uint32_t), 1, inputFile) == 1) {
+                segments->mapped[0][i++] = convert_endian(word);
+        }
+        fclose(inputFile);
+        decode_program(segments);
+        return segments;
+}
+
+/* best time in ms over 'runs' loads of 'path' */
+static double best_ms(Segment_T (*load)(const char*), const char* path,
+                      int runs)
+{
+        double best = -1;
+        for (int r = 0; r < runs; r++) {
+                double start = bench_seconds();
+                Segment_T segments = load(path);
+                double elapsed = bench_seconds() - start;
+                if (segments == NULL) {
+                        return -1;
+                }
+                segment_deinit(segments);
+                if (best < 0 || elapsed < best) {
+                        best = elapsed;
+                }
+        }
+        return best * 1e3;
+}
+
+static int is_program(const char* name)
+{
+        const char* dot = strrchr(name, '.');
+        return dot != NULL && (strcmp(dot, ".um") == 0 ||
+                               strcmp(dot, ".umz") == 0);
+}
+
+int main(int argc, char *argv[])
+{
+        const char* dir = argc > 1 ? argv[1] : "../umbin";
+        int runs = argc > 2 ? atoi(argv[2]) : 10;
+
+        DIR* listing = opendir(dir);
+        if (listing == NULL) {
+                fprintf(stderr, "%s: No such file or directory\n", dir);
+                return EXIT_FAILURE;
+        }
+
+        printf("%-16s %10s %12s %12s\n", "program", "bytes", "fread ms",
+               "mmap ms");
+        struct dirent* entry;
+        while ((entry = readdir(listing)) != NULL) {
+                if (!is_program(entry->d_name)) {
+                        continue;
+                }
+                char path[4096];
+                snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name);
+                struct stat fileStat;
+                if (stat(path, &fileStat) != 0) {
+                        continue;
+                }
+                printf("%-16s %10lld %12.3f %12.3f\n", entry->d_name,
+                       (long long)fileStat.st_size,
+                       best_ms(fread_program, path, runs),
+                       best_ms(load_program, path, runs));
+        }
+        closedir(listing);
+        return EXIT_SUCCESS;
+}
@@ -0,0 +1,546 @@
+/**************************************************************
+ *                        bench_versions.c
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   Benchmarks every engine generation (v1 to v9) on the
+ *                  programs in umbin: midmark, sandmark (checked
+ *                  against sandmark.out), advent with advent.txt as its
+ *                  input, and codex with no input, which boots and then
+ *                  halts at the login prompt.
+ *
+ *                      ./bench_versions [-n runs] [-c cpu] [-t timeout]
+ *                                       [-r root] [-b build_dir]
+ *                                       [-m make_args] [-j out.json]
+ *                                       [-w workload] [-p program.um]
+ *                                       [version...]
+ *
+ *                  Each version is copied from 'root' (.. by default)
+ *                  into 'build_dir' and built there with its own
+ *                  Makefile, so the tree is left alone; -m passes
+ *                  variables such as IFLAGS to those makes. Every run
+ *                  is pinned to one CPU (-c, or the last one; -1 not
+ *                  to pin), and its output is checked against what the
+ *                  v9 core in this program prints, which also gives the
+ *                  instruction count for MIPS. Reports the median wall
+ *                  time, MIPS and peak RSS of 'runs' runs as a table,
+ *                  and as JSON with -j.
+ *
+ *                  -p adds a program of one's own, run with no input,
+ *                  such as the images bench_gen writes; -w or -p pick
+ *                  the workloads, which are otherwise all four.
+ *
+ **************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "segments.h"
+#include "execute.h"
+#include "load.h"
+#include "io.h"
+#include "bench.h"
+
+#define MAX_RUNS 99
+#define MAX_WORKLOADS 64
+#define PATH_SIZE 4096
+
+/* program, input (NULL: none) and expected output (NULL: whatever the
+ * v9 core prints), relative to umbin unless absolute */
+static struct {
+        const char* name;
+        const char* program;
+        const char* input;
+        const char* expected;
+        uint64_t instructions;
+        uint64_t digest;
+        bool selected;
+} workloads[MAX_WORKLOADS] = {
+        { "midmark", "midmark.um", NULL, NULL, 0, 0, false },
+        { "sandmark", "sandmark.umz", NULL, "sandmark.out", 0, 0, false },
+        { "advent", "advent.umz", "advent.txt", NULL, 0, 0, false },
+        { "codex", "codex.umz", NULL, NULL, 0, 0, false },
+};
+
+static size_t num_workloads = 4;
+
+typedef enum { OK, WRONG_OUTPUT, FAILED, TIMED_OUT, NOT_BUILT } Outcome;
+
+static const char* const outcome_names[] = {
+        "ok", "wrong output", "failed", "timed out", "not built"
+};
+
+typedef struct {
+        const char* version;
+        size_t workload;
+        Outcome outcome;
+        int runs;
+        double seconds[MAX_RUNS];
+        long peak_rss_kb;
+} Result;
+
+static const uint64_t FNV_OFFSET = 14695981039346656037ull;
+
+static uint64_t fnv(uint64_t digest, const unsigned char* bytes,
+                    size_t length)
+{
+        for (size_t i = 0; i < length; i++) {
+                digest = (digest ^ bytes[i]) * 1099511628211ull;
+        }
+        return digest;
+}
+
+static void digest_write(void* sink, const unsigned char* bytes,
+                         size_t length)
+{
+        uint64_t* digest = sink;
+        *digest = fnv(*digest, bytes, length);
+}
+
+/* digest of a whole file; false if it can't be read */
+static bool digest_file(const char* path, uint64_t* digest)
+{
+        FILE* file = fopen(path, "rb");
+        if (file == NULL) {
+                return false;
+        }
+        unsigned char chunk[65536];
+        size_t n;
+        *digest = FNV_OFFSET;
+        while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+                *digest = fnv(*digest, chunk, n);
+        }
+        fclose(file);
+        return true;
+}
+
+/* where a workload's 'file' is */
+static void umbin_path(char* path, size_t size, const char* umbin,
+                       const char* file)
+{
+        if (file[0] == '/') {
+                snprintf(path, size, "%s", file);
+        } else {
+                snprintf(path, size, "%s/%s", umbin, file);
+        }
+}
+
+/* fd for a workload's input, /dev/null if it has none */
+static int open_input(const char* umbin, const char* input)
+{
+        char path[2 * PATH_SIZE];
+        if (input == NULL) {
+                return open("/dev/null", O_RDONLY);
+        }
+        umbin_path(path, sizeof(path), umbin, input);
+        return open(path, O_RDONLY);
+}
+
+/* instructions workload 'w' runs on the v9 core, 0 if it didn't halt,
+ * and the digest of what it printed */
+static uint64_t reference_counts(const char* umbin, size_t w,
+                                 uint64_t* digest)
+{
+        char path[2 * PATH_SIZE];
+        umbin_path(path, sizeof(path), umbin, workloads[w].program);
+        Segment_T segments = load_program(path);
+        int in = open_input(umbin, workloads[w].input);
+        if (segments == NULL || in < 0) {
+                fprintf(stderr, "can't open %s\n", path);
+                return 0;
+        }
+        *digest = FNV_OFFSET;
+        segments->io = io_new(io_read_fd, (void*)(intptr_t)in,
+                              digest_write, digest);
+        uint32_t registers[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        uint32_t pc = 0;
+        uint64_t steps = 0;
+        Exec_status status = execute_for(segments, registers, &pc, &steps,
+                                         UINT64_MAX);
+        segment_deinit(segments);
+        close(in);
+        if (status != EXEC_HALTED) {
+                fprintf(stderr, "%s did not halt\n", path);
+                return 0;
+        }
+        return steps;
+}
+
+/* runs workload 'w' once on the v9 core for its instruction count and
+ * the digest of its output; in a child process, as forked runs would
+ * otherwise count the memory it used in their peak RSS */
+static bool reference_run(const char* umbin, size_t w)
+{
+        int results[2];
+        if (pipe(results) != 0) {
+                return false;
+        }
+        pid_t child = fork();
+        if (child == 0) {
+                close(results[0]);
+                uint64_t found[2];
+                found[0] = reference_counts(umbin, w, &found[1]);
+                _exit(write(results[1], found, sizeof(found)) ==
+                      sizeof(found) && found[0] != 0 ? 0 : 1);
+        }
+        close(results[1]);
+        uint64_t found[2];
+        bool ok = child > 0 && read(results[0], found, sizeof(found)) ==
+                  sizeof(found) && found[0] != 0;
+        close(results[0]);
+        while (child > 0 && waitpid(child, NULL, 0) < 0 && errno == EINTR) {
+        }
+        if (!ok) {
+                return false;
+        }
+
+        workloads[w].instructions = found[0];
+        workloads[w].digest = found[1];
+        if (workloads[w].expected != NULL) {
+                char path[2 * PATH_SIZE];
+                umbin_path(path, sizeof(path), umbin,
+                           workloads[w].expected);
+                uint64_t expected = 0;
+                if (!digest_file(path, &expected) || expected != found[1]) {
+                        fprintf(stderr, "v9 core output differs from "
+                                "%s\n", path);
+                }
+                workloads[w].digest = expected;
+        }
+        return true;
+}
+
+/* copies 'root/version' to 'build_dir/version' and makes um there */
+static bool build(const char* root, const char* build_dir,
+                  const char* version, const char* make_args)
+{
+        char command[16384];
+        snprintf(command, sizeof(command),
+                 "mkdir -p '%s' && rm -rf '%s/%s' && "
+                 "cp -r '%s/%s' '%s/%s' && "
+                 "make -s -C '%s/%s' clean >/dev/null && "
+                 "make -s -C '%s/%s' um %s >/dev/null",
+                 build_dir, build_dir, version, root, version, build_dir,
+                 version, build_dir, version, build_dir, version, make_args);
+        return system(command) == 0;
+}
+
+/* one run: wall time and peak RSS, and whether its output was right */
+static Outcome run_once(const char* um, const char* umbin, size_t w,
+                        int cpu, double timeout, double* seconds,
+                        long* rss_kb)
+{
+        char program[2 * PATH_SIZE];
+        umbin_path(program, sizeof(program), umbin, workloads[w].program);
+        int in = open_input(umbin, workloads[w].input);
+        int out[2];
+        if (in < 0 || pipe(out) != 0) {
+                return FAILED;
+        }
+
+        double start = bench_seconds();
+        pid_t child = fork();
+        if (child == 0) {
+                if (cpu >= 0) {
+                        cpu_set_t set;
+                        CPU_ZERO(&set);
+                        CPU_SET(cpu, &set);
+                        sched_setaffinity(0, sizeof(set), &set);
+                }
+                int null = open("/dev/null", O_WRONLY);
+                dup2(in, STDIN_FILENO);
+                dup2(out[1], STDOUT_FILENO);
+                dup2(null, STDERR_FILENO);
+                close(out[0]);
+                execl(um, um, program, (char*)NULL);
+                _exit(127);
+        }
+        close(in);
+        close(out[1]);
+        if (child < 0) {
+                close(out[0]);
+                return FAILED;
+        }
+
+        uint64_t digest = FNV_OFFSET;
+        bool timed_out = false;
+        unsigned char chunk[65536];
+        for (;;) {
+                int wait_ms = -1;
+                if (timeout > 0) {
+                        double left = start + timeout - bench_seconds();
+                        wait_ms = left > 0 ? (int)(left * 1000) + 1 : 0;
+                }
+                struct pollfd ready = { .fd = out[0], .events = POLLIN };
+                int n = poll(&ready, 1, wait_ms);
+                if (n < 0 && errno == EINTR) {
+                        continue;
+                }
+                if (n == 0) {
+                        timed_out = true;
+                        kill(child, SIGKILL);
+                        break;
+                }
+                ssize_t got = read(out[0], chunk, sizeof(chunk));
+                if (got < 0 && errno == EINTR) {
+                        continue;
+                }
+                if (got <= 0) {
+                        break;
+                }
+                digest = fnv(digest, chunk, got);
+        }
+        close(out[0]);
+
+        int status;
+        struct rusage usage;
+        while (wait4(child, &status, 0, &usage) < 0 && errno == EINTR) {
+        }
+        *seconds = bench_seconds() - start;
+        *rss_kb = usage.ru_maxrss;
+
+        if (timed_out) {
+                return TIMED_OUT;
+        }
+        if (!WIFEXITED(status) || WEXITSTATUS(status) == 127) {
+                return FAILED;
+        }
+        return digest == workloads[w].digest ? OK : WRONG_OUTPUT;
+}
+
+static int compare(const void* a, const void* b)
+{
+        double x = *(const double*)a, y = *(const double*)b;
+        return (x > y) - (x < y);
+}
+
+/* of a result's run times, which stay in run order */
+static double median(const Result* r)
+{
+        double sorted[MAX_RUNS];
+        memcpy(sorted, r->seconds, sizeof(double) * r->runs);
+        qsort(sorted, r->runs, sizeof(double), compare);
+        return r->runs % 2 == 1 ? sorted[r->runs / 2] :
+               (sorted[r->runs / 2 - 1] + sorted[r->runs / 2]) / 2;
+}
+
+static void write_json(const char* path, Result* results, size_t count,
+                       int runs, int cpu)
+{
+        FILE* out = fopen(path, "w");
+        if (out == NULL) {
+                perror(path);
+                return;
+        }
+        fprintf(out, "{\n  \"runs\": %d,\n  \"cpu\": %d,\n"
+                "  \"workloads\": [", runs, cpu);
+        bool first = true;
+        for (size_t w = 0; w < num_workloads; w++) {
+                if (workloads[w].selected) {
+                        fprintf(out, "%s\n    {\"name\": \"%s\", "
+                                "\"instructions\": %llu}",
+                                first ? "" : ",", workloads[w].name,
+                                (unsigned long long)
+                                workloads[w].instructions);
+                        first = false;
+                }
+        }
+        fprintf(out, "\n  ],\n  \"results\": [");
+        for (size_t i = 0; i < count; i++) {
+                Result* r = &results[i];
+                fprintf(out, "%s\n    {\"version\": \"%s\", \"workload\": "
+                        "\"%s\", \"status\": \"%s\", \"times_s\": [",
+                        i == 0 ? "" : ",", r->version,
+                        workloads[r->workload].name,
+                        outcome_names[r->outcome]);
+                for (int k = 0; k < r->runs; k++) {
+                        fprintf(out, "%s%.6f", k == 0 ? "" : ", ",
+                                r->seconds[k]);
+                }
+                fprintf(out, "]");
+                if (r->outcome == OK) {
+                        double m = median(r);
+                        uint64_t instructions =
+                                workloads[r->workload].instructions;
+                        fprintf(out, ", \"median_s\": %.6f, \"mips\": %.3f, "
+                                "\"ns_per_instruction\": %.3f, "
+                                "\"peak_rss_kb\": %ld", m,
+                                instructions / m / 1e6,
+                                m * 1e9 / instructions, r->peak_rss_kb);
+                }
+                fprintf(out, "}");
+        }
+        fprintf(out, "\n  ]\n}\n");
+        fclose(out);
+}
+
+static void usage(const char* name)
+{
+        fprintf(stderr, "usage: %s [-n runs] [-c cpu] [-t timeout] "
+                "[-r root] [-b build_dir] [-m make_args] [-j out.json] "
+                "[-w workload] [-p program.um] [version...]\n", name);
+        exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[])
+{
+        int runs = 3;
+        int cpu = sysconf(_SC_NPROCESSORS_ONLN) - 1;
+        double timeout = 0;
+        const char* root = "..";
+        const char* build_dir = "/tmp/um-versions";
+        const char* make_args = "";
+        const char* json = NULL;
+        bool any_selected = false;
+        int opt;
+        while ((opt = getopt(argc, argv, "n:c:t:r:b:m:j:w:p:")) != -1) {
+                switch (opt) {
+                case 'n':
+                        runs = atoi(optarg);
+                        break;
+                case 'c':
+                        cpu = atoi(optarg);
+                        break;
+                case 't':
+                        timeout = atof(optarg);
+                        break;
+                case 'r':
+                        root = optarg;
+                        break;
+                case 'b':
+                        build_dir = optarg;
+                        break;
+                case 'm':
+                        make_args = optarg;
+                        break;
+                case 'j':
+                        json = optarg;
+                        break;
+                case 'w': {
+                        size_t w = 0;
+                        while (w < num_workloads &&
+                               strcmp(workloads[w].name, optarg) != 0) {
+                                w++;
+                        }
+                        if (w == num_workloads) {
+                                usage(argv[0]);
+                        }
+                        workloads[w].selected = any_selected = true;
+                        break;
+                }
+                case 'p': {
+                        char* path = realpath(optarg, NULL);
+                        if (path == NULL || num_workloads == MAX_WORKLOADS) {
+                                usage(argv[0]);
+                        }
+                        /* named after the file, less its extension */
+                        char* name = strdup(strrchr(path, '/') + 1);
+                        char* dot = strrchr(name, '.');
+                        if (dot != NULL && dot != name) {
+                                *dot = '\0';
+                        }
+                        size_t w = num_workloads++;
+                        workloads[w].name = name;
+                        workloads[w].program = path;
+                        workloads[w].selected = any_selected = true;
+                        break;
+                }
+                default:
+                        usage(argv[0]);
+                }
+        }
+        if (runs < 1 || runs > MAX_RUNS) {
+                usage(argv[0]);
+        }
+        for (size_t w = 0; w < num_workloads && !any_selected; w++) {
+                workloads[w].selected = true;
+        }
+        static const char* const all_versions[] = {
+                "v1", "v2", "v3", "v4", "v5", "v6", "v7", "v8", "v9"
+        };
+        const char* const* versions = all_versions;
+        size_t num_versions = 9;
+        if (optind < argc) {
+                versions = (const char* const*)&argv[optind];
+                num_versions = argc - optind;
+        }
+
+        char umbin[PATH_SIZE];
+        snprintf(umbin, sizeof(umbin), "%s/umbin", root);
+        for (size_t w = 0; w < num_workloads; w++) {
+                if (workloads[w].selected && !reference_run(umbin, w)) {
+                        return EXIT_FAILURE;
+                }
+        }
+
+        Result* results = calloc(num_versions * num_workloads,
+                                 sizeof(Result));
+        size_t count = 0;
+        for (size_t v = 0; v < num_versions; v++) {
+                bool built = build(root, build_dir, versions[v], make_args);
+                char um[2 * PATH_SIZE];
+                snprintf(um, sizeof(um), "%s/%s/um", build_dir, versions[v]);
+                for (size_t w = 0; w < num_workloads; w++) {
+                        if (!workloads[w].selected) {
+                                continue;
+                        }
+                        Result* r = &results[count++];
+                        r->version = versions[v];
+                        r->workload = w;
+                        r->outcome = built ? OK : NOT_BUILT;
+                        while (r->outcome == OK && r->runs < runs) {
+                                long rss_kb = 0;
+                                r->outcome = run_once(um, umbin, w, cpu,
+                                                      timeout,
+                                                      &r->seconds[r->runs],
+                                                      &rss_kb);
+                                r->runs++;
+                                if (rss_kb > r->peak_rss_kb) {
+                                        r->peak_rss_kb = rss_kb;
+                                }
+                        }
+                        fprintf(stderr, "%s %s: %s\n", versions[v],
+                                workloads[w].name,
+                                outcome_names[r->outcome]);
+                }
+        }
+
+        printf("%-8s %-9s %14s %10s %9s %9s %12s  %s\n", "version",
+               "workload", "instructions", "median s", "MIPS", "ns/instr",
+               "peak RSS MB", "check");
+        for (size_t i = 0; i < count; i++) {
+                Result* r = &results[i];
+                uint64_t instructions = workloads[r->workload].instructions;
+                printf("%-8s %-9s %14llu ", r->version,
+                       workloads[r->workload].name,
+                       (unsigned long long)instructions);
+                if (r->outcome == OK) {
+                        double m = median(r);
+                        printf("%10.3f %9.1f %9.2f %12.1f  ", m,
+                               instructions / m / 1e6,
+                               m * 1e9 / instructions,
+                               r->peak_rss_kb / 1024.0);
+                } else {
+                        printf("%10s %9s %9s %12s  ", "-", "-", "-", "-");
+                }
+                printf("%s\n", outcome_names[r->outcome]);
+        }
+        if (json != NULL) {
+                write_json(json, results, count, runs, cpu);
+        }
+        free(results);
+        return EXIT_SUCCESS;
+}
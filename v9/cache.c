@@ -0,0 +1,132 @@
+/**************************************************************
+ *                        cache.c
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   Decompressed-image cache on top of snapshot files.
+ *
+ **************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "cache.h"
+#include "snapshot.h"
+#include "execute.h"
+#include "load.h"
+
+char* image_cache_pending = NULL;
+static uint64_t image_key;
+
+/* FNV-1a over the file's words as stored (the byte order doesn't matter
+ * for a key), then its length; never 0, which snapshot_load ignores */
+static uint64_t file_hash(const char* program)
+{
+        int fd = open(program, O_RDONLY);
+        struct stat fileStat;
+        if (fd < 0 || fstat(fd, &fileStat) != 0) {
+                if (fd >= 0) {
+                        close(fd);
+                }
+                return 0;
+        }
+
+        uint64_t hash = 14695981039346656037ull;
+        size_t length = fileStat.st_size / sizeof(uint32_t);
+        if (length > 0) {
+                const uint32_t* words = mmap(NULL, length * sizeof(uint32_t),
+                                             PROT_READ, MAP_PRIVATE, fd, 0);
+                if (words == MAP_FAILED) {
+                        close(fd);
+                        return 0;
+                }
+                for (size_t i = 0; i < length; i++) {
+                        hash = (hash ^ words[i]) * 1099511628211ull;
+                }
+                munmap((void*)words, length * sizeof(uint32_t));
+        }
+        close(fd);
+        hash = (hash ^ (uint64_t)fileStat.st_size) * 1099511628211ull;
+        return hash != 0 ? hash : 1;
+}
+
+static char* cache_path(const char* dir, uint64_t key, const char* suffix)
+{
+        size_t size = strlen(dir) + 32;
+        char* path = malloc(size);
+        snprintf(path, size, "%s/%016llx.%s", dir, (unsigned long long)key,
+                 suffix);
+        return path;
+}
+
+/* segment 0 of a fresh machine for 'program', mapped from its image file,
+ * which is written first if need be; a private load if that fails */
+static Segment_T open_image(const char* dir, const char* program)
+{
+        uint32_t registers[8];
+        uint32_t pc;
+        char* path = cache_path(dir, image_key, "umimg");
+        Segment_T segments = snapshot_load(path, image_key, registers, &pc);
+        if (segments == NULL) {
+                segments = load_program(program);
+                uint32_t zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+                if (segments != NULL &&
+                    snapshot_save(path, image_key, segments, zeros, 0)) {
+                        Segment_T mapped = snapshot_load(path, image_key,
+                                                         registers, &pc);
+                        if (mapped != NULL) {
+                                segment_deinit(segments);
+                                segments = mapped;
+                        }
+                }
+        }
+        free(path);
+        return segments;
+}
+
+Segment_T image_cache_open(const char* dir, const char* program,
+                           uint32_t registers[8], uint32_t* pc)
+{
+        image_key = file_hash(program);
+        if (image_key == 0) {
+                return NULL;
+        }
+
+        char* path = cache_path(dir, image_key, "umsnap");
+        Segment_T cached = snapshot_load(path, image_key, registers, pc);
+        if (cached != NULL) {
+                free(path);
+                return cached;
+        }
+
+        Segment_T segments = open_image(dir, program);
+        if (segments == NULL) {
+                free(path);
+                return NULL;
+        }
+        memset(registers, 0, sizeof(uint32_t) * 8);
+        *pc = 0;
+        image_cache_pending = path;
+        return segments;
+}
+
+void image_cache_loadp(Segment_T segments, const uint32_t registers[8],
+                       uint32_t pc)
+{
+        if (segment_length(segments->mapped[0]) < CACHE_MIN_WORDS) {
+                return;
+        }
+        if (!io_started(segments->io)) {
+                snapshot_save(image_cache_pending, image_key, segments,
+                              registers, pc);
+        }
+        free(image_cache_pending);
+        image_cache_pending = NULL;
+}
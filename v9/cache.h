@@ -0,0 +1,48 @@
+/**************************************************************
+ *                        cache.h
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   Opt-in on-disk cache of program images, keyed by a
+ *                  hash of the image file. Two snapshots per image:
+ *
+ *                  - <key>.umimg, the image as loaded: byte-swapped and
+ *                    decoded. Mapped copy-on-write as segment 0, so
+ *                    every process running the same image shares those
+ *                    pages until it writes to segment 0 or LOADPs.
+ *                  - <key>.umsnap, the machine at the first LOADP of a
+ *                    big segment: where the .umz programs, having
+ *                    unpacked themselves, jump into the real program.
+ *                    Later runs start from it instead. It is only taken
+ *                    if the program has done no I/O yet, since that
+ *                    couldn't be replayed.
+ *
+ **************************************************************/
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdint.h>
+#include "segments.h"
+
+/* LOADPs of fewer words than this aren't worth a snapshot */
+#define CACHE_MIN_WORDS 4096
+
+/* non-NULL while a snapshot is still wanted; tested on every program
+ * load, so execute() pays one compare when caching is off */
+extern char* image_cache_pending;
+
+/* a machine for 'program' through cache directory 'dir', with its
+ * registers and pc: the unpacked program if cached, otherwise the mapped
+ * image (arming the unpacked snapshot). NULL if 'program' can't be read */
+Segment_T image_cache_open(const char* dir, const char* program,
+                           uint32_t registers[8], uint32_t* pc);
+
+/* called right after a LOADP made segment 0 a copy of another segment,
+ * with 'pc' the jump target */
+void image_cache_loadp(Segment_T segments, const uint32_t registers[8],
+                       uint32_t pc);
+
+#endif
@@ -0,0 +1,67 @@
+/**************************************************************
+ *                        checkpoint.c
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   Checkpoint triggers and taking the snapshot.
+ *
+ **************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <signal.h>
+#include "checkpoint.h"
+#include "snapshot.h"
+#include "execute.h"
+
+volatile sig_atomic_t checkpoint_requested = 0;
+uint64_t checkpoint_at = UINT64_MAX;
+static const char* checkpoint_path = NULL;
+
+static void request_checkpoint(int signal)
+{
+        (void)signal;
+        checkpoint_requested = 1;
+}
+
+void checkpoint_arm(const char* path, uint64_t at)
+{
+        checkpoint_path = path;
+        checkpoint_at = at;
+
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = request_checkpoint;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGUSR1, &action, NULL);
+}
+
+void checkpoint_take(Segment_T segments, const uint32_t registers[8],
+                     uint32_t pc, uint64_t steps)
+{
+        if (checkpoint_path == NULL) {
+                checkpoint_requested = 0;
+                checkpoint_at = UINT64_MAX;
+                return;
+        }
+        Io_T io = segments->io;
+        if (io->input_next != io->input_end) {
+                return;
+        }
+
+        checkpoint_requested = 0;
+        checkpoint_at = UINT64_MAX;
+        io_flush(io);
+        if (snapshot_save(checkpoint_path, 0, segments, registers, pc)) {
+                fprintf(stderr, "checkpoint: %s after %llu instructions\n",
+                        checkpoint_path, (unsigned long long)steps);
+        } else {
+                fprintf(stderr, "checkpoint: can't write %s\n",
+                        checkpoint_path);
+        }
+}
@@ -0,0 +1,45 @@
+/**************************************************************
+ *                        checkpoint.h
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   Checkpointing a running machine to a snapshot file
+ *                  (um --checkpoint FILE), on SIGUSR1 or once a given
+ *                  number of instructions has run. `um --restore FILE`
+ *                  carries on from it.
+ *
+ *                  Requests are only acted on at a jump (LOADP, or
+ *                  between compiled blocks), once all input read so far
+ *                  has been consumed, so the snapshot never loses bytes
+ *                  the program had been handed.
+ *
+ **************************************************************/
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <signal.h>
+#include "segments.h"
+
+extern volatile sig_atomic_t checkpoint_requested;
+extern uint64_t checkpoint_at;
+
+/* checkpoint to 'path' on SIGUSR1, and after 'at' instructions unless it
+ * is UINT64_MAX */
+void checkpoint_arm(const char* path, uint64_t at);
+
+static inline bool checkpoint_due(uint64_t steps)
+{
+        return checkpoint_requested | (steps >= checkpoint_at);
+}
+
+/* save the machine, about to run 'pc' after 'steps' instructions, if
+ * input allows; otherwise the request stays pending */
+void checkpoint_take(Segment_T segments, const uint32_t registers[8],
+                     uint32_t pc, uint64_t steps);
+
+#endif
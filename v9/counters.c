@@ -0,0 +1,133 @@
+/**************************************************************
+ *                        counters.c
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   perf_event_open counters and their report.
+ *
+ **************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "counters.h"
+
+#define CACHE_READ_MISS(cache) ((cache) | \
+                                PERF_COUNT_HW_CACHE_OP_READ << 8 | \
+                                PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+
+/* fd is -1 for a counter that isn't there */
+static struct {
+        const char* name;
+        uint32_t type;
+        uint64_t config;
+        int fd;
+} counters[] = {
+        { "task-clock", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, -1 },
+        { "cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1 },
+        { "instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS,
+          -1 },
+        { "branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES,
+          -1 },
+        { "L1d-misses", PERF_TYPE_HW_CACHE,
+          CACHE_READ_MISS(PERF_COUNT_HW_CACHE_L1D), -1 },
+        { "LLC-misses", PERF_TYPE_HW_CACHE,
+          CACHE_READ_MISS(PERF_COUNT_HW_CACHE_LL), -1 },
+};
+
+#define NUM_COUNTERS (sizeof(counters) / sizeof(counters[0]))
+
+enum { TASK_CLOCK, CYCLES, INSTRUCTIONS };
+
+bool counters_start(void)
+{
+        bool any = false;
+        for (size_t i = 0; i < NUM_COUNTERS; i++) {
+                struct perf_event_attr attr;
+                memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                attr.type = counters[i].type;
+                attr.config = counters[i].config;
+                attr.disabled = 1;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                                   PERF_FORMAT_TOTAL_TIME_RUNNING;
+                counters[i].fd = syscall(SYS_perf_event_open, &attr, 0, -1,
+                                         -1, 0);
+                any |= counters[i].fd >= 0;
+        }
+        for (size_t i = 0; i < NUM_COUNTERS; i++) {
+                if (counters[i].fd >= 0) {
+                        ioctl(counters[i].fd, PERF_EVENT_IOC_ENABLE, 0);
+                }
+        }
+        return any;
+}
+
+void counters_report(uint64_t steps, uint64_t dispatches, FILE* out)
+{
+        double values[NUM_COUNTERS];
+        double coverage[NUM_COUNTERS];
+        for (size_t i = 0; i < NUM_COUNTERS; i++) {
+                if (counters[i].fd >= 0) {
+                        ioctl(counters[i].fd, PERF_EVENT_IOC_DISABLE, 0);
+                }
+        }
+        for (size_t i = 0; i < NUM_COUNTERS; i++) {
+                /* value, time enabled, time running */
+                uint64_t read_back[3];
+                values[i] = -1;
+                if (counters[i].fd < 0) {
+                        continue;
+                }
+                if (read(counters[i].fd, read_back, sizeof(read_back)) ==
+                    sizeof(read_back) && read_back[2] > 0) {
+                        coverage[i] = (double)read_back[2] / read_back[1];
+                        values[i] = read_back[0] / coverage[i];
+                }
+                close(counters[i].fd);
+                counters[i].fd = -1;
+        }
+
+        double per = steps > 0 ? 1.0 / steps : 0;
+        double per_dispatch = dispatches > 0 ? 1.0 / dispatches : 0;
+        fprintf(out, "perf counters over %llu UM instructions, %llu "
+                "dispatches:\n", (unsigned long long)steps,
+                (unsigned long long)dispatches);
+        fprintf(out, "  %-14s %18s  %15s  %12s\n", "", "total",
+                "per instruction", "per dispatch");
+        for (size_t i = 0; i < NUM_COUNTERS; i++) {
+                if (values[i] < 0) {
+                        fprintf(out, "  %-14s %18s\n", counters[i].name,
+                                "not supported");
+                        continue;
+                }
+                if (i == TASK_CLOCK) {
+                        fprintf(out, "  %-14s %15.3f ms  %12.3f ns  "
+                                "%9.3f ns", counters[i].name,
+                                values[i] / 1e6, values[i] * per,
+                                values[i] * per_dispatch);
+                } else {
+                        fprintf(out, "  %-14s %18.0f  %15.4f  %12.4f",
+                                counters[i].name, values[i],
+                                values[i] * per, values[i] * per_dispatch);
+                }
+                if (i == INSTRUCTIONS && values[CYCLES] > 0) {
+                        fprintf(out, ", %.2f per cycle",
+                                values[i] / values[CYCLES]);
+                }
+                if (coverage[i] < 1) {
+                        fprintf(out, " (scaled, counted %.0f%% of the time)",
+                                100 * coverage[i]);
+                }
+                fprintf(out, "\n");
+        }
+}
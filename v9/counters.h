@@ -0,0 +1,36 @@
+/**************************************************************
+ *                        counters.h
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   Host performance counters around a run of the
+ *                  machine (um --perf-counters), through perf_event_open:
+ *                  task clock, cycles, instructions, branch misses, and
+ *                  L1d and last-level cache read misses, per UM
+ *                  instruction and per dispatch (a superinstruction or
+ *                  a JIT block runs several instructions on one).
+ *
+ *                  Counters the kernel or CPU doesn't offer (say, in a
+ *                  VM without a PMU) are reported as unsupported; the
+ *                  others are counted in user space only, and scaled up
+ *                  if the kernel had to multiplex them.
+ *
+ **************************************************************/
+
+#ifndef COUNTERS_H
+#define COUNTERS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* opens and starts the counters for this thread; false if none open */
+bool counters_start(void);
+
+/* stops them and reports them per UM instruction and per dispatch, of
+ * which 'steps' and 'dispatches' ran */
+void counters_report(uint64_t steps, uint64_t dispatches, FILE* out);
+
+#endif
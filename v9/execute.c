@@ -0,0 +1,733 @@
+/**************************************************************
+ *                        execute.c
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       11/20/2023
+ *
+ *       Summary:   The UM interpreter loop, in its switch and threaded
+ *                  dispatch variants, and the instruction helpers it
+ *                  inlines.
+ * 
+ **************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "execute.h"
+#include "cache.h"
+#include "checkpoint.h"
+#include "sample.h"
+#ifdef UM_JIT
+#include "jit.h"
+#endif
+
+inline void cond_move(uint32_t* regA, uint32_t regB, uint32_t regC)
+{
+        if (regC != 0) {
+             *regA = regB;
+        }
+}
+
+inline void add(uint32_t* regA, uint32_t regB, uint32_t regC)
+{
+        *regA = (uint32_t)(regB + regC);
+}
+
+inline void mult(uint32_t *regA, uint32_t regB, uint32_t regC)
+{
+        *regA = (uint32_t)(regB * regC);
+}
+
+inline void divide(uint32_t *regA, uint32_t regB, uint32_t regC)
+{
+        *regA = (regB / regC);
+}
+
+inline void bit_NAND(uint32_t* regA, uint32_t regB, uint32_t regC)
+{
+        *regA = ~(regB & regC);
+}
+
+/* JIT builds run compiled blocks until an instruction needs the
+ * interpreter */
+#ifdef UM_JIT
+#define JIT_ENTER()                                                     \
+        do {                                                            \
+                uint64_t before = steps;                                \
+                prog_counter = jit_run(segments, registers,             \
+                                       prog_counter, &steps, limit);    \
+                folded += steps - before;                               \
+                JUMP_CHECK();                                           \
+        } while (0)
+#else
+#define JIT_ENTER() ((void)0)
+#endif
+
+/*
+ * Profile builds (make PROFILE=1) count opcode bigrams and trigrams over
+ * the executed UM instruction stream, and how many instructions ran as
+ * the second half of a superinstruction. The report goes to stderr at
+ * HALT.
+ */
+#ifdef UM_PROFILE
+
+static __thread uint64_t bigrams[16 * 16];
+static __thread uint64_t trigrams[16 * 16 * 16];
+static __thread uint64_t executed, fused;
+static __thread uint32_t history;
+
+static inline void profile_op(uint8_t op)
+{
+        history = ((history << 4) | op) & 0xFFF;
+        bigrams[history & 0xFF]++;
+        trigrams[history]++;
+        executed++;
+}
+
+static void print_ngrams(const char* title, uint64_t* counts, int n)
+{
+        static const char* const names[16] = {
+                "CMOV", "SLOAD", "SSTORE", "ADD", "MULT", "DIV", "NAND",
+                "HALT", "MAP", "UNMAP", "OUTPUT", "INPUT", "LOADP", "LOADV",
+                "OP14", "OP15"
+        };
+        int size = 1 << (4 * n);
+
+        fprintf(stderr, "top %s:\n", title);
+        for (int rank = 0; rank < 10; rank++) {
+                int best = 0;
+                for (int i = 1; i < size; i++) {
+                        if (counts[i] > counts[best]) {
+                                best = i;
+                        }
+                }
+                if (counts[best] == 0) {
+                        break;
+                }
+                fprintf(stderr, "  %6.2f%%  ", 100.0 * counts[best] / executed);
+                for (int k = n - 1; k >= 0; k--) {
+                        fprintf(stderr, " %s", names[(best >> (4 * k)) & 15]);
+                }
+                fprintf(stderr, "\n");
+                counts[best] = 0;
+        }
+}
+
+static void profile_report(void)
+{
+        /* 'fused' counts superinstructions, each covering two words */
+        uint64_t unfused = executed - 2 * fused;
+
+        fprintf(stderr, "%llu instructions in %llu dispatches: %llu fused, "
+                "%llu unfused (fused/unfused %.3f)\n",
+                (unsigned long long)executed,
+                (unsigned long long)(executed - fused),
+                (unsigned long long)(2 * fused), (unsigned long long)unfused,
+                unfused ? (double)(2 * fused) / unfused : 0.0);
+        print_ngrams("bigrams", bigrams, 2);
+        print_ngrams("trigrams", trigrams, 3);
+}
+
+#define PROFILE_OP(op) profile_op(base_op(op))
+#define PROFILE_FUSED(op) (profile_op(base_op(op)), fused++)
+#define PROFILE_REPORT() (profile_report(), \
+                          segment_report(segments, stderr))
+
+#else
+
+#define PROFILE_OP(op) ((void)0)
+#define PROFILE_FUSED(op) ((void)0)
+#define PROFILE_REPORT() ((void)0)
+
+#endif
+
+/*
+ * Stats builds (make STATS=1) count executions per opcode, with both
+ * halves of a superinstruction counted, the sizes of segments mapped and
+ * unmapped, and whether each LOADP was a jump or copied a segment. A
+ * table goes to stderr at HALT, then a JSON report, to $UM_STATS_JSON if
+ * that names a file. Blocks run by the JIT are not counted.
+ */
+#ifdef UM_STATS
+
+/* size classes: 0 words, then [2^(k-1), 2^k) words for class k */
+#define SIZE_CLASSES 33
+
+static __thread uint64_t op_counts[16];
+static __thread uint64_t fused_count;
+static __thread uint64_t map_sizes[SIZE_CLASSES], unmap_sizes[SIZE_CLASSES];
+static __thread uint64_t map_words, unmap_words;
+static __thread uint64_t loadp_jumps, loadp_copies, loadp_words;
+
+static const char* const op_names[16] = {
+        "CMOV", "SLOAD", "SSTORE", "ADD", "MULT", "DIV", "NAND", "HALT",
+        "MAP", "UNMAP", "OUTPUT", "INPUT", "LOADP", "LOADV", "OP14", "OP15"
+};
+
+static inline int size_class(uint32_t words)
+{
+        return words == 0 ? 0 : 32 - __builtin_clz(words);
+}
+
+static inline void stats_map(uint32_t words)
+{
+        map_sizes[size_class(words)]++;
+        map_words += words;
+}
+
+static inline void stats_unmap(Segment_T segments, uint32_t id)
+{
+        uint32_t words = segment_length(segments->mapped[id]);
+        unmap_sizes[size_class(words)]++;
+        unmap_words += words;
+}
+
+static inline void stats_loadp(Segment_T segments, uint32_t id)
+{
+        if (id == 0) {
+                loadp_jumps++;
+        } else {
+                loadp_copies++;
+                loadp_words += segment_length(segments->mapped[id]);
+        }
+}
+
+static void print_sizes(const char* title, const uint64_t* sizes,
+                        uint64_t words)
+{
+        uint64_t total = 0;
+        for (int k = 0; k < SIZE_CLASSES; k++) {
+                total += sizes[k];
+        }
+        fprintf(stderr, "%s: %llu segments, %llu words\n", title,
+                (unsigned long long)total, (unsigned long long)words);
+        for (int k = 0; k < SIZE_CLASSES; k++) {
+                if (sizes[k] == 0) {
+                        continue;
+                }
+                uint64_t low = k == 0 ? 0 : (uint64_t)1 << (k - 1);
+                uint64_t high = k == 0 ? 0 : ((uint64_t)1 << k) - 1;
+                char range[32];
+                snprintf(range, sizeof(range), "%llu-%llu",
+                         (unsigned long long)low, (unsigned long long)high);
+                fprintf(stderr, "  %-21s %14llu  %6.2f%%\n", range,
+                        (unsigned long long)sizes[k],
+                        100.0 * sizes[k] / total);
+        }
+}
+
+static void json_sizes(FILE* out, const char* name, const uint64_t* sizes,
+                       uint64_t words)
+{
+        fprintf(out, ",\n  \"%s\": {\"words\": %llu, \"sizes\": [", name,
+                (unsigned long long)words);
+        bool first = true;
+        for (int k = 0; k < SIZE_CLASSES; k++) {
+                if (sizes[k] == 0) {
+                        continue;
+                }
+                uint64_t low = k == 0 ? 0 : (uint64_t)1 << (k - 1);
+                uint64_t high = k == 0 ? 0 : ((uint64_t)1 << k) - 1;
+                fprintf(out, "%s{\"min\": %llu, \"max\": %llu, "
+                        "\"count\": %llu}", first ? "" : ", ",
+                        (unsigned long long)low, (unsigned long long)high,
+                        (unsigned long long)sizes[k]);
+                first = false;
+        }
+        fprintf(out, "]}");
+}
+
+/* at HALT, which 'steps' leaves out but the counts include */
+static void stats_report(uint64_t steps)
+{
+        uint64_t counted = 0;
+        for (int op = 0; op < 16; op++) {
+                counted += op_counts[op];
+        }
+        uint64_t instructions = steps + 1;
+
+        fprintf(stderr, "%llu instructions, %llu in %llu interpreter "
+                "dispatches\n", (unsigned long long)instructions,
+                (unsigned long long)counted,
+                (unsigned long long)(counted - fused_count));
+        for (int op = 0; op < 16; op++) {
+                if (op_counts[op] != 0) {
+                        fprintf(stderr, "  %-7s %14llu  %6.2f%%\n",
+                                op_names[op],
+                                (unsigned long long)op_counts[op],
+                                100.0 * op_counts[op] / counted);
+                }
+        }
+        print_sizes("MAP", map_sizes, map_words);
+        print_sizes("UNMAP", unmap_sizes, unmap_words);
+        fprintf(stderr, "LOADP: %llu jumps, %llu copies of %llu words\n",
+                (unsigned long long)loadp_jumps,
+                (unsigned long long)loadp_copies,
+                (unsigned long long)loadp_words);
+
+        const char* path = getenv("UM_STATS_JSON");
+        FILE* out = path != NULL ? fopen(path, "w") : NULL;
+        if (out == NULL) {
+                if (path != NULL) {
+                        perror(path);
+                }
+                out = stderr;
+        }
+        fprintf(out, "{\n  \"instructions\": %llu,\n  \"counted\": %llu,\n"
+                "  \"dispatches\": %llu,\n  \"opcodes\": {",
+                (unsigned long long)instructions, (unsigned long long)counted,
+                (unsigned long long)(counted - fused_count));
+        for (int op = 0; op < 14; op++) {
+                fprintf(out, "%s\"%s\": %llu", op == 0 ? "" : ", ",
+                        op_names[op], (unsigned long long)op_counts[op]);
+        }
+        fprintf(out, "}");
+        json_sizes(out, "map", map_sizes, map_words);
+        json_sizes(out, "unmap", unmap_sizes, unmap_words);
+        fprintf(out, ",\n  \"loadp\": {\"jumps\": %llu, \"copies\": %llu, "
+                "\"copied_words\": %llu}\n}\n",
+                (unsigned long long)loadp_jumps,
+                (unsigned long long)loadp_copies,
+                (unsigned long long)loadp_words);
+        if (out != stderr) {
+                fclose(out);
+        }
+}
+
+#define STATS_OP(op) (op_counts[base_op(op)]++)
+#define STATS_FUSED(op) (op_counts[base_op(op)]++, fused_count++)
+#define STATS_MAP(words) stats_map(words)
+#define STATS_UNMAP(id) stats_unmap(segments, id)
+#define STATS_LOADP(id) stats_loadp(segments, id)
+#define STATS_REPORT() stats_report(steps)
+
+#else
+
+#define STATS_OP(op) ((void)0)
+#define STATS_FUSED(op) ((void)0)
+#define STATS_MAP(words) ((void)0)
+#define STATS_UNMAP(id) ((void)0)
+#define STATS_LOADP(id) ((void)0)
+#define STATS_REPORT() ((void)0)
+
+#endif
+
+/* second half of a superinstruction */
+#define FUSED_NEXT() \
+        (ins = program[prog_counter++], steps++, folded++,              \
+         PROFILE_FUSED(ins.op), STATS_FUSED(ins.op))
+
+/* after a LOADP of another segment, whose target is registers[ins.c] */
+#define CACHE_LOADP()                                                   \
+        do {                                                            \
+                if (__builtin_expect(image_cache_pending != NULL, 0)) { \
+                        image_cache_loadp(segments, registers,          \
+                                          registers[ins.c]);            \
+                }                                                       \
+        } while (0)
+
+/* leave the machine at the instruction just fetched, which hasn't run */
+#define STOP_AT(why)                                                    \
+        do {                                                            \
+                prog_counter--;                                         \
+                steps--;                                                \
+                status = (why);                                         \
+                goto stop;                                              \
+        } while (0)
+
+/* after a jump: a target past the end marker (see decode_program) is a
+ * fault, and the budget is only checked here */
+#define JUMP_CHECK()                                                    \
+        do {                                                            \
+                if (__builtin_expect(prog_counter > length, 0)) {       \
+                        status = EXEC_FAULT;                            \
+                        goto stop;                                      \
+                }                                                       \
+                if (__builtin_expect(steps >= limit, 0)) {              \
+                        status = EXEC_BUDGET;                           \
+                        goto stop;                                      \
+                }                                                       \
+        } while (0)
+
+/* checkpoints are taken at jumps, once prog_counter is the target */
+#define CHECKPOINT_POLL()                                               \
+        do {                                                            \
+                if (__builtin_expect(checkpoint_due(steps), 0)) {       \
+                        checkpoint_take(segments, registers,            \
+                                        prog_counter, steps);           \
+                }                                                       \
+        } while (0)
+
+/* the state execute_for starts from; an out-of-range pc or an empty
+ * budget stops it before the first instruction */
+#define EXEC_ENTER()                                                    \
+        uint32_t registers[8];                                          \
+        memcpy(registers, state, sizeof(registers));                    \
+        uint32_t prog_counter = *pc;                                    \
+        uint64_t steps = *count;                                        \
+        uint64_t limit = budget > UINT64_MAX - steps ? UINT64_MAX :     \
+                         steps + budget;                                \
+        /* instructions run without a dispatch of their own */          \
+        uint64_t folded = 0;                                            \
+        Instruction* program = segments->program;                       \
+        uint32_t length = segment_length(segments->mapped[0]);          \
+        Exec_status status;                                             \
+        sample_jump(segments, prog_counter);                            \
+        JUMP_CHECK()
+
+/* hand the state back; output is flushed at the end of every slice */
+#define EXEC_LEAVE()                                                    \
+        do {                                                            \
+                memcpy(state, registers, sizeof(registers));            \
+                *pc = prog_counter;                                     \
+                segments->dispatches += steps - *count - folded;        \
+                *count = steps;                                         \
+                io_flush(segments->io);                                 \
+                if (status == EXEC_HALTED) {                            \
+                        PROFILE_REPORT();                               \
+                        STATS_REPORT();                                 \
+                }                                                       \
+                return status;                                          \
+        } while (0)
+
+Exec_status execute(Segment_T segments, const uint32_t start_registers[8],
+                    uint32_t start_pc)
+{
+        uint32_t registers[8];
+        memcpy(registers, start_registers, sizeof(registers));
+        uint64_t steps = 0;
+        return execute_for(segments, registers, &start_pc, &steps,
+                           UINT64_MAX);
+}
+
+#ifndef THREADED_DISPATCH
+
+/* switch dispatch: every instruction funnels through one indirect branch */
+Exec_status execute_for(Segment_T segments, uint32_t state[8],
+                        uint32_t* pc, uint64_t* count, uint64_t budget)
+{
+        EXEC_ENTER();
+
+        /* iterate through instructions until the machine stops */
+        for (;;) {
+                JIT_ENTER();
+                Instruction ins = program[prog_counter++];
+                steps++;
+                PROFILE_OP(ins.op);
+                STATS_OP(ins.op);
+
+                switch (ins.op) {
+                case LOADV:
+                        registers[ins.a] = ins.value;
+                        break;
+                case OUTPUT:
+                        output(segments->io, registers[ins.c]);
+                        break;
+                case CMOV:
+                        cond_move(&registers[ins.a],
+                                   registers[ins.b],
+                                   registers[ins.c]);
+                        break;
+                case SLOAD:
+                        registers[ins.a] = segment_get_word(segments,
+                                                registers[ins.b],
+                                                registers[ins.c]);
+                        break;
+                case SSTORE:
+                        segment_store_word(segments, registers[ins.a],
+                                                     registers[ins.b],
+                                                     registers[ins.c]);
+                        break;
+                case NAND:
+                        bit_NAND(&registers[ins.a],
+                                  registers[ins.b],
+                                  registers[ins.c]);
+                        break;
+                case INPUT:
+                        if (!input(segments->io, &registers[ins.c])) {
+                                STOP_AT(EXEC_BLOCKED);
+                        }
+                        break;
+                case ADD:
+                        add(&registers[ins.a],
+                             registers[ins.b],
+                             registers[ins.c]);
+                        break;
+                case MULT:
+                        mult(&registers[ins.a],
+                              registers[ins.b],
+                              registers[ins.c]);
+                        break;
+                case DIV:
+                        divide(&registers[ins.a],
+                                registers[ins.b],
+                                registers[ins.c]);
+                        break;
+                case MAP:
+                        STATS_MAP(registers[ins.c]);
+                        registers[ins.b] = segment_new(segments,
+                                                registers[ins.c]);
+                        break;
+                case UNMAP:
+                        STATS_UNMAP(registers[ins.c]);
+                        segment_free(segments, registers[ins.c]);
+                        break;
+                case LOADP:
+                        STATS_LOADP(registers[ins.b]);
+                        if (registers[ins.b] != 0) {
+                                segment_duplicate(segments,
+                                                  registers[ins.b]);
+                                program = segments->program;
+                                length = segment_length(segments->mapped[0]);
+                                sample_load(segments);
+                                CACHE_LOADP();
+                        }
+                        prog_counter = registers[ins.c];
+                        sample_jump(segments, prog_counter);
+                        JUMP_CHECK();
+                        CHECKPOINT_POLL();
+                        break;
+                case HALT:
+                        STOP_AT(EXEC_HALTED);
+                case LOADV_SLOAD:
+                        registers[ins.a] = ins.value;
+                        FUSED_NEXT();
+                        registers[ins.a] = segment_get_word(segments,
+                                                registers[ins.b],
+                                                registers[ins.c]);
+                        break;
+                case LOADV_SSTORE:
+                        registers[ins.a] = ins.value;
+                        FUSED_NEXT();
+                        segment_store_word(segments, registers[ins.a],
+                                                     registers[ins.b],
+                                                     registers[ins.c]);
+                        break;
+                case SSTORE_LOADV:
+                        segment_store_word(segments, registers[ins.a],
+                                                     registers[ins.b],
+                                                     registers[ins.c]);
+                        /* a store into segment 0 may have rewritten the
+                         * next word */
+                        if (registers[ins.a] == 0) {
+                                break;
+                        }
+                        FUSED_NEXT();
+                        registers[ins.a] = ins.value;
+                        break;
+                case SLOAD_LOADV:
+                        registers[ins.a] = segment_get_word(segments,
+                                                registers[ins.b],
+                                                registers[ins.c]);
+                        FUSED_NEXT();
+                        registers[ins.a] = ins.value;
+                        break;
+                case LOADV_LOADV:
+                        registers[ins.a] = ins.value;
+                        FUSED_NEXT();
+                        registers[ins.a] = ins.value;
+                        break;
+                case NAND_NAND:
+                        bit_NAND(&registers[ins.a],
+                                  registers[ins.b],
+                                  registers[ins.c]);
+                        FUSED_NEXT();
+                        bit_NAND(&registers[ins.a],
+                                  registers[ins.b],
+                                  registers[ins.c]);
+                        break;
+                case ADD_SLOAD:
+                        add(&registers[ins.a],
+                             registers[ins.b],
+                             registers[ins.c]);
+                        FUSED_NEXT();
+                        registers[ins.a] = segment_get_word(segments,
+                                                registers[ins.b],
+                                                registers[ins.c]);
+                        break;
+                default:
+                        STOP_AT(EXEC_FAULT);
+                }
+        }
+
+stop:
+        EXEC_LEAVE();
+}
+
+#else
+
+/*
+ * threaded dispatch: each handler ends in its own copy of the fetch and
+ * indirect jump (GCC labels-as-values), so the branch predictor sees one
+ * branch per opcode instead of a single shared one
+ */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+
+#define DISPATCH()                                                      \
+        do {                                                            \
+                JIT_ENTER();                                            \
+                ins = program[prog_counter++];                          \
+                steps++;                                                \
+                PROFILE_OP(ins.op);                                     \
+                STATS_OP(ins.op);                                       \
+                goto *dispatch_table[ins.op];                           \
+        } while (0)
+
+Exec_status execute_for(Segment_T segments, uint32_t state[8],
+                        uint32_t* pc, uint64_t* count, uint64_t budget)
+{
+        static void *const dispatch_table[NUM_OPS] = {
+                &&do_cmov, &&do_sload, &&do_sstore, &&do_add,
+                &&do_mult, &&do_div, &&do_nand, &&do_halt,
+                &&do_map, &&do_unmap, &&do_output, &&do_input,
+                &&do_loadp, &&do_loadv, &&do_invalid, &&do_invalid,
+                &&do_loadv_sload, &&do_loadv_sstore, &&do_sstore_loadv,
+                &&do_sload_loadv, &&do_loadv_loadv, &&do_nand_nand,
+                &&do_add_sload
+        };
+
+        EXEC_ENTER();
+        Instruction ins;
+
+        DISPATCH();
+
+do_loadv:
+        registers[ins.a] = ins.value;
+        DISPATCH();
+do_output:
+        output(segments->io, registers[ins.c]);
+        DISPATCH();
+do_cmov:
+        cond_move(&registers[ins.a],
+                   registers[ins.b],
+                   registers[ins.c]);
+        DISPATCH();
+do_sload:
+        registers[ins.a] = segment_get_word(segments,
+                                registers[ins.b],
+                                registers[ins.c]);
+        DISPATCH();
+do_sstore:
+        segment_store_word(segments, registers[ins.a],
+                                     registers[ins.b],
+                                     registers[ins.c]);
+        DISPATCH();
+do_nand:
+        bit_NAND(&registers[ins.a],
+                  registers[ins.b],
+                  registers[ins.c]);
+        DISPATCH();
+do_input:
+        if (!input(segments->io, &registers[ins.c])) {
+                STOP_AT(EXEC_BLOCKED);
+        }
+        DISPATCH();
+do_add:
+        add(&registers[ins.a],
+             registers[ins.b],
+             registers[ins.c]);
+        DISPATCH();
+do_mult:
+        mult(&registers[ins.a],
+              registers[ins.b],
+              registers[ins.c]);
+        DISPATCH();
+do_div:
+        divide(&registers[ins.a],
+                registers[ins.b],
+                registers[ins.c]);
+        DISPATCH();
+do_map:
+        STATS_MAP(registers[ins.c]);
+        registers[ins.b] = segment_new(segments,
+                                registers[ins.c]);
+        DISPATCH();
+do_unmap:
+        STATS_UNMAP(registers[ins.c]);
+        segment_free(segments, registers[ins.c]);
+        DISPATCH();
+do_loadp:
+        STATS_LOADP(registers[ins.b]);
+        if (registers[ins.b] != 0) {
+                segment_duplicate(segments, registers[ins.b]);
+                program = segments->program;
+                length = segment_length(segments->mapped[0]);
+                sample_load(segments);
+                CACHE_LOADP();
+        }
+        prog_counter = registers[ins.c];
+        sample_jump(segments, prog_counter);
+        JUMP_CHECK();
+        CHECKPOINT_POLL();
+        DISPATCH();
+do_loadv_sload:
+        registers[ins.a] = ins.value;
+        FUSED_NEXT();
+        registers[ins.a] = segment_get_word(segments,
+                                registers[ins.b],
+                                registers[ins.c]);
+        DISPATCH();
+do_loadv_sstore:
+        registers[ins.a] = ins.value;
+        FUSED_NEXT();
+        segment_store_word(segments, registers[ins.a],
+                                     registers[ins.b],
+                                     registers[ins.c]);
+        DISPATCH();
+do_sstore_loadv:
+        segment_store_word(segments, registers[ins.a],
+                                     registers[ins.b],
+                                     registers[ins.c]);
+        /* a store into segment 0 may have rewritten the next word */
+        if (registers[ins.a] == 0) {
+                DISPATCH();
+        }
+        FUSED_NEXT();
+        registers[ins.a] = ins.value;
+        DISPATCH();
+do_sload_loadv:
+        registers[ins.a] = segment_get_word(segments,
+                                registers[ins.b],
+                                registers[ins.c]);
+        FUSED_NEXT();
+        registers[ins.a] = ins.value;
+        DISPATCH();
+do_loadv_loadv:
+        registers[ins.a] = ins.value;
+        FUSED_NEXT();
+        registers[ins.a] = ins.value;
+        DISPATCH();
+do_nand_nand:
+        bit_NAND(&registers[ins.a],
+                  registers[ins.b],
+                  registers[ins.c]);
+        FUSED_NEXT();
+        bit_NAND(&registers[ins.a],
+                  registers[ins.b],
+                  registers[ins.c]);
+        DISPATCH();
+do_add_sload:
+        add(&registers[ins.a],
+             registers[ins.b],
+             registers[ins.c]);
+        FUSED_NEXT();
+        registers[ins.a] = segment_get_word(segments,
+                                registers[ins.b],
+                                registers[ins.c]);
+        DISPATCH();
+do_invalid:
+        STOP_AT(EXEC_FAULT);
+do_halt:
+        STOP_AT(EXEC_HALTED);
+stop:
+        EXEC_LEAVE();
+}
+
+#undef DISPATCH
+#pragma GCC diagnostic pop
+
+#endif
@@ -0,0 +1,44 @@
+/**************************************************************
+ *                        execute.h
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       11/20/2023
+ *
+ *       Summary:   Interface to the UM interpreter loop. It includes
+ *                  io.h, which has the I/O instructions, so translated
+ *                  programs (see um2c.c) need only this header.
+ * 
+ **************************************************************/
+
+#ifndef EXECUTE_H
+#define EXECUTE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "segments.h"
+#include "io.h"
+
+/* why execute_for stopped */
+typedef enum {
+        EXEC_HALTED,    /* at a HALT */
+        EXEC_BLOCKED,   /* at an INPUT, with no input ready (IO_BLOCKED) */
+        EXEC_BUDGET,    /* after a jump, with the budget spent */
+        EXEC_FAULT      /* at an invalid instruction, past the end of
+                         * segment 0 or at a jump outside it */
+} Exec_status;
+
+/* run the machine at '*pc' until it stops, adding the instructions run to
+ * '*steps' (and the dispatches to segments->dispatches); 'registers' and
+ * '*pc' are left where it stopped, so calling again resumes it. The budget is only checked at jumps, so a slice can
+ * overrun it by the straight-line code before the next one. */
+Exec_status execute_for(Segment_T segments, uint32_t registers[8],
+                        uint32_t* pc, uint64_t* steps, uint64_t budget);
+
+/* run from 'start_pc' with the given register file until it stops, which
+ * with blocking input means HALT or a fault */
+Exec_status execute(Segment_T segments, const uint32_t start_registers[8],
+                    uint32_t start_pc);
+
+#endif
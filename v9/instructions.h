@@ -0,0 +1,121 @@
+/**************************************************************
+ *                        instructions.h
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       11/20/2023
+ *
+ *       Summary: UM opcodes, instruction word field masks, and the
+ *                decoded form of a segment 0 word. Everything here is
+ *                static inline so the dispatch loop stays branch-free
+ *                of calls.
+ * 
+ **************************************************************/
+
+#ifndef INSTRUCTIONS_H
+#define INSTRUCTIONS_H
+
+#include <stdint.h>
+
+static const uint32_t REG_A_MASK = 7 << 6;
+static const uint32_t REG_B_MASK = 7 << 3;
+static const uint32_t REG_C_MASK = 7;
+static const uint32_t OP_CODE_MASK = 15UL << 28;
+static const uint32_t LOADVAL_VALUE_MASK = (1UL << 25) - 1;
+static const uint32_t LOADVAL_REG_A_MASK = 7 << 25;
+
+/* 14 and 15 are not instructions; INVALID also marks the end of a decoded
+ * segment 0 */
+typedef enum opcode {
+        CMOV = 0, SLOAD, SSTORE, ADD, MULT, DIV, NAND,
+        HALT, MAP, UNMAP, OUTPUT, INPUT, LOADP, LOADV, INVALID
+} opcode;
+
+/* segment 0 word with its fields already extracted; for LOADV, 'a' is the
+ * target register and 'value' the immediate */
+typedef struct {
+        uint8_t op;
+        uint8_t a, b, c;
+        uint32_t value;
+} Instruction;
+
+/* superinstructions: a fused op replaces the decoded op of the first word
+ * of a hot pair (chosen from sandmark's bigram profile); its handler runs
+ * that word and then the next entry, which keeps its own unfused decoding
+ * for jumps that land on it */
+enum fused_opcode {
+        FIRST_FUSED = 16,
+        LOADV_SLOAD = FIRST_FUSED, LOADV_SSTORE, SSTORE_LOADV, SLOAD_LOADV,
+        LOADV_LOADV, NAND_NAND, ADD_SLOAD, NUM_OPS
+};
+
+static const uint8_t FUSED_PAIRS[NUM_OPS - FIRST_FUSED][2] = {
+        { LOADV, SLOAD }, { LOADV, SSTORE }, { SSTORE, LOADV },
+        { SLOAD, LOADV }, { LOADV, LOADV }, { NAND, NAND }, { ADD, SLOAD }
+};
+
+static inline uint8_t base_op(uint8_t op)
+{
+        return op >= FIRST_FUSED ? FUSED_PAIRS[op - FIRST_FUSED][0] : op;
+}
+
+/* op for an entry decoded as 'first' that is followed by 'second' */
+static inline uint8_t fuse(uint8_t first, uint8_t second)
+{
+        first = base_op(first);
+        second = base_op(second);
+        for (int i = 0; i < NUM_OPS - FIRST_FUSED; i++) {
+                if (FUSED_PAIRS[i][0] == first &&
+                    FUSED_PAIRS[i][1] == second) {
+                        return FIRST_FUSED + i;
+                }
+        }
+        return first;
+}
+
+static inline opcode get_opcode(uint32_t word)
+{
+        return (opcode)((word & OP_CODE_MASK) >> 28);
+}
+
+static inline uint32_t regA(uint32_t word)
+{
+        return (word & REG_A_MASK) >> 6;
+}
+
+static inline uint32_t regB(uint32_t word)
+{
+        return (word & REG_B_MASK) >> 3;
+}
+
+static inline uint32_t regC(uint32_t word)
+{
+        return word & REG_C_MASK;
+}
+
+static inline Instruction decode_word(uint32_t word)
+{
+        Instruction ins;
+        ins.op = get_opcode(word);
+        if (ins.op == LOADV) {
+                ins.a = (word & LOADVAL_REG_A_MASK) >> 25;
+                ins.b = ins.c = 0;
+                ins.value = word & LOADVAL_VALUE_MASK;
+        } else {
+                ins.a = regA(word);
+                ins.b = regB(word);
+                ins.c = regC(word);
+                ins.value = 0;
+        }
+        return ins;
+}
+
+static inline uint32_t convert_endian(uint32_t value)
+{
+        return ((value & 0xFF) << 24) |
+               (((value >> 8) & 0xFF) << 16) |
+               (((value >> 16) & 0xFF) << 8) |
+               ((value >> 24) & 0xFF);
+}
+
+#endif
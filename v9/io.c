@@ -0,0 +1,92 @@
+/**************************************************************
+ *                        io.c
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   Buffer refills and flushes for a machine's I/O, and
+ *                  the file descriptor callbacks.
+ *
+ **************************************************************/
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include "io.h"
+
+ssize_t io_read_fd(void* source, unsigned char* buffer, size_t size)
+{
+        int fd = (int)(intptr_t)source;
+        ssize_t n;
+        do {
+                n = read(fd, buffer, size);
+        } while (n < 0 && errno == EINTR);
+        return n;
+}
+
+void io_write_fd(void* sink, const unsigned char* bytes, size_t length)
+{
+        int fd = (int)(intptr_t)sink;
+        size_t written = 0;
+        while (written < length) {
+                ssize_t n = write(fd, bytes + written, length - written);
+                if (n < 0 && errno == EINTR) {
+                        continue;
+                }
+                if (n <= 0) {
+                        break;
+                }
+                written += n;
+        }
+}
+
+Io_T io_new(Io_read read, void* source, Io_write write, void* sink)
+{
+        Io_T io = malloc(sizeof(*io));
+        io->output_length = 0;
+        io->line_flush = false;
+        io->input_next = 0;
+        io->input_end = 0;
+        io->started = false;
+        io->read = read;
+        io->source = source;
+        io->write = write;
+        io->sink = sink;
+        return io;
+}
+
+Io_T io_new_fd(int in_fd, int out_fd)
+{
+        Io_T io = io_new(io_read_fd, (void*)(intptr_t)in_fd,
+                         io_write_fd, (void*)(intptr_t)out_fd);
+        io->line_flush = isatty(out_fd);
+        return io;
+}
+
+void io_free(Io_T io)
+{
+        io_flush(io);
+        free(io);
+}
+
+void io_flush(Io_T io)
+{
+        if (io->output_length != 0) {
+                io->started = true;
+                io->write(io->sink, io->output, io->output_length);
+                io->output_length = 0;
+        }
+}
+
+ssize_t io_fill(Io_T io)
+{
+        io_flush(io);
+        io->started = true;
+
+        ssize_t n = io->read(io->source, io->input, IO_BUFFER_SIZE);
+        io->input_next = 0;
+        io->input_end = n > 0 ? (size_t)n : 0;
+        return n;
+}
@@ -0,0 +1,125 @@
+/**************************************************************
+ *                        io.h
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   A machine's I/O channels. OUTPUT and INPUT are
+ *                  inline here so that the interpreter and translated
+ *                  programs (see um2c.c) share them.
+ *
+ *                  OUTPUT appends to a buffer instead of going through
+ *                  printf per byte. The buffer is written out when it
+ *                  fills, at HALT, at every newline if the output is a
+ *                  terminal, and before INPUT waits for more input (so
+ *                  prompts appear first).
+ *
+ *                  INPUT takes bytes from a buffer refilled in bulk;
+ *                  only a refill flushes output, so a filter like cat.um
+ *                  doesn't make a write per byte.
+ *
+ *                  Each machine has its own Io_T, so machines can run
+ *                  side by side in one process (see um_batch.c). Bytes
+ *                  move through read/write callbacks; io_new_fd gives
+ *                  the usual ones over file descriptors.
+ *
+ **************************************************************/
+
+#ifndef IO_H
+#define IO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/types.h>
+
+#define IO_BUFFER_SIZE 65536
+
+/* what a read callback returns when no input is ready yet; INPUT then
+ * stops the machine (see execute_for) instead of seeing end of input */
+#define IO_BLOCKED (-2)
+
+/* fill 'buffer' with up to 'size' bytes; 0 at end of input, IO_BLOCKED
+ * if none is ready yet */
+typedef ssize_t (*Io_read)(void* source, unsigned char* buffer, size_t size);
+
+/* consume all 'length' bytes */
+typedef void (*Io_write)(void* sink, const unsigned char* bytes,
+                         size_t length);
+
+/**************************************************************
+ * The Io_T struct consists of:
+ *      - output/output_length: bytes OUTPUT but not yet written.
+ *      - line_flush: write at every newline.
+ *      - input/input_next/input_end: bytes read but not yet INPUT.
+ *      - started: something was already written or read.
+ *      - read/source, write/sink: where the bytes go.
+ *************************************************************/
+typedef struct Io {
+        unsigned char output[IO_BUFFER_SIZE];
+        size_t output_length;
+        bool line_flush;
+        unsigned char input[IO_BUFFER_SIZE];
+        size_t input_next;
+        size_t input_end;
+        bool started;
+        Io_read read;
+        void* source;
+        Io_write write;
+        void* sink;
+} *Io_T;
+
+Io_T io_new(Io_read read, void* source, Io_write write, void* sink);
+
+/* the callbacks io_new_fd uses; 'source'/'sink' is the fd cast to a
+ * pointer */
+ssize_t io_read_fd(void* source, unsigned char* buffer, size_t size);
+void io_write_fd(void* sink, const unsigned char* bytes, size_t length);
+
+/* read from 'in_fd' and write to 'out_fd', flushing at newlines if
+ * 'out_fd' is a terminal */
+Io_T io_new_fd(int in_fd, int out_fd);
+
+/* flushes, then frees */
+void io_free(Io_T io);
+
+/* write out everything buffered so far */
+void io_flush(Io_T io);
+
+/* flush output, then read more input; returns what the read callback
+ * did: bytes read, 0 (or an error) at end of input, or IO_BLOCKED */
+ssize_t io_fill(Io_T io);
+
+/* whether the program has written or read anything yet */
+static inline bool io_started(Io_T io)
+{
+        return io->started || io->output_length != 0;
+}
+
+static inline void output(Io_T io, uint32_t regC)
+{
+        io->output[io->output_length++] = regC;
+        if (io->output_length == IO_BUFFER_SIZE ||
+            (regC == '\n' && io->line_flush)) {
+                io_flush(io);
+        }
+}
+
+/* false, leaving *regC alone, if no input is ready yet */
+static inline bool input(Io_T io, uint32_t* regC)
+{
+        if (__builtin_expect(io->input_next == io->input_end, 0)) {
+                ssize_t n = io_fill(io);
+                if (n == IO_BLOCKED) {
+                        return false;
+                }
+                if (n <= 0) {
+                        *regC = 0xFFFFFFFF;
+                        return true;
+                }
+        }
+        *regC = io->input[io->input_next++];
+        return true;
+}
+
+#endif
@@ -0,0 +1,479 @@
+/**************************************************************
+ *                        jit.c
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/16/2026
+ *
+ *       Summary:   x86-64 basic-block compiler for segment 0.
+ *
+ *                  A block is a run of CMOV/SLOAD/SSTORE/ADD/MULT/DIV/
+ *                  NAND/LOADV, optionally closed by a LOADP that only
+ *                  jumps. It is compiled to a function
+ *                      uint64_t block(uint32_t* registers, Segment_T)
+ *                  that loads UM r0-r7 into r8d-r15d, runs, stores them
+ *                  back and returns the next pc, with bit 32 set when
+ *                  the interpreter must execute that instruction, and
+ *                  the number of UM instructions it ran in bits 48-63
+ *                  (a block can stop early, or leave its LOADP to the
+ *                  interpreter).
+ *
+ *                  entry[pc] caches the block starting at pc. An SSTORE
+ *                  into segment 0 clears every entry whose block could
+ *                  cover the written word; LOADP of another segment
+ *                  flushes everything through decode_program.
+ *
+ **************************************************************/
+
+#ifndef __x86_64__
+#error "the UM JIT only targets x86-64"
+#endif
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <sys/mman.h>
+#include "jit.h"
+#include "checkpoint.h"
+#include "sample.h"
+
+#define CODE_SIZE (32u << 20)
+#define MAX_BLOCK 256
+/* generous bound on the bytes one UM instruction can compile to */
+#define MAX_INSN_BYTES 256
+#define EXIT_TO_INTERPRETER (1ULL << 32)
+#define RAN_SHIFT 48
+
+typedef uint64_t (*Block)(uint32_t* registers, Segment_T segments);
+
+/* entry[] marker for a pc whose instruction the interpreter must run */
+#define INTERPRET ((Block)(uintptr_t)1)
+
+struct Jit {
+        uint8_t* code;
+        size_t used;
+        Block* entry;
+        uint8_t* covered;
+        uint32_t length;
+        uint64_t invalidations;
+};
+
+enum { RAX = 0, RCX, RDX, RBX, RSP, RBP, RSI, RDI };
+
+/* host register holding UM register i */
+#define UM(i) (8 + (i))
+
+#define SEGMENT_FIELD(f) offsetof(__typeof__(*(Segment_T)0), f)
+
+Jit_T jit_new(void)
+{
+        Jit_T jit = malloc(sizeof(*jit));
+        jit->code = mmap(NULL, CODE_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        assert(jit->code != MAP_FAILED);
+        jit->used = 0;
+        jit->entry = NULL;
+        jit->covered = NULL;
+        jit->length = 0;
+        jit->invalidations = 0;
+        return jit;
+}
+
+void jit_free(Jit_T jit)
+{
+        munmap(jit->code, CODE_SIZE);
+        free(jit->entry);
+        free(jit->covered);
+        free(jit);
+}
+
+void jit_flush(Jit_T jit, uint32_t length)
+{
+        if (length != jit->length || jit->entry == NULL) {
+                /* fresh (lazily zeroed, for big programs) tables */
+                free(jit->entry);
+                free(jit->covered);
+                jit->entry = calloc(length + 1, sizeof(Block));
+                jit->covered = calloc(length + 1, 1);
+                jit->length = length;
+        } else {
+                memset(jit->entry, 0, sizeof(Block) * (length + 1));
+                memset(jit->covered, 0, length + 1);
+        }
+        jit->used = 0;
+}
+
+static inline bool ends_block(uint8_t op)
+{
+        return op == HALT || op == MAP || op == UNMAP || op == OUTPUT ||
+               op == INPUT || op == LOADP || op > LOADV;
+}
+
+void jit_invalidate(Jit_T jit, Instruction* program, uint32_t offset)
+{
+        if (offset >= jit->length) {
+                return;
+        }
+        if (jit->entry[offset] == INTERPRET) {
+                jit->entry[offset] = NULL;
+        }
+        if (!jit->covered[offset]) {
+                return;
+        }
+
+        /* any block covering 'offset' starts at most MAX_BLOCK - 1 words
+         * back and has no block-ending instruction before 'offset' */
+        jit->invalidations++;
+        for (uint32_t s = offset; ; s--) {
+                if (s != offset && ends_block(program[s].op)) {
+                        break;
+                }
+                jit->entry[s] = NULL;
+                if (s == 0 || offset - s + 1 == MAX_BLOCK) {
+                        break;
+                }
+        }
+}
+
+/* called from compiled code for an SSTORE into segment 0 or a shared
+ * segment; nonzero means compiled code was invalidated and the block
+ * must stop */
+static int sstore_slow(Segment_T segments, uint32_t segment_id,
+                       uint32_t offset, uint32_t value)
+{
+        uint64_t before = segments->jit->invalidations;
+        segment_store_word(segments, segment_id, offset, value);
+        return segments->jit->invalidations != before;
+}
+
+/*
+ * x86-64 encoding
+ */
+
+static inline void emit8(Jit_T jit, uint8_t byte)
+{
+        jit->code[jit->used++] = byte;
+}
+
+static inline void emit32(Jit_T jit, uint32_t value)
+{
+        memcpy(jit->code + jit->used, &value, sizeof(value));
+        jit->used += sizeof(value);
+}
+
+static inline void emit64(Jit_T jit, uint64_t value)
+{
+        memcpy(jit->code + jit->used, &value, sizeof(value));
+        jit->used += sizeof(value);
+}
+
+static void emit_op(Jit_T jit, bool wide, int op, int reg, int index,
+                    int base)
+{
+        uint8_t rex = 0x40 | (wide << 3) | ((reg >> 3) << 2) |
+                      ((index >> 3) << 1) | (base >> 3);
+        if (rex != 0x40) {
+                emit8(jit, rex);
+        }
+        if (op > 0xFF) {
+                emit8(jit, op >> 8);
+        }
+        emit8(jit, op & 0xFF);
+}
+
+/* op reg, rm (both registers); 'reg' may be an opcode extension */
+static void emit_rr(Jit_T jit, bool wide, int op, int reg, int rm)
+{
+        emit_op(jit, wide, op, reg, 0, rm);
+        emit8(jit, 0xC0 | (reg & 7) << 3 | (rm & 7));
+}
+
+/* op reg, [base + disp]; base must not be rsp/r12 */
+static void emit_mem(Jit_T jit, bool wide, int op, int reg, int base,
+                     int32_t disp)
+{
+        emit_op(jit, wide, op, reg, 0, base);
+        if (disp >= -128 && disp <= 127) {
+                emit8(jit, 0x40 | (reg & 7) << 3 | (base & 7));
+                emit8(jit, (uint8_t)disp);
+        } else {
+                emit8(jit, 0x80 | (reg & 7) << 3 | (base & 7));
+                emit32(jit, (uint32_t)disp);
+        }
+}
+
+/* op reg, [base + index << scale]; base must not be rbp/r13 */
+static void emit_sib(Jit_T jit, bool wide, int op, int reg, int base,
+                     int index, int scale)
+{
+        emit_op(jit, wide, op, reg, index, base);
+        emit8(jit, 0x04 | (reg & 7) << 3);
+        emit8(jit, scale << 6 | (index & 7) << 3 | (base & 7));
+}
+
+static void emit_mov_imm(Jit_T jit, int reg, uint32_t value)
+{
+        emit_op(jit, false, 0xB8 + (reg & 7), 0, 0, reg);
+        emit32(jit, value);
+}
+
+/* jcc/jmp rel32 with the displacement left for patch() */
+static size_t emit_jump(Jit_T jit, int op)
+{
+        if (op > 0xFF) {
+                emit8(jit, op >> 8);
+        }
+        emit8(jit, op & 0xFF);
+        emit32(jit, 0);
+        return jit->used;
+}
+
+static void patch(Jit_T jit, size_t jump_end)
+{
+        uint32_t rel = (uint32_t)(jit->used - jump_end);
+        memcpy(jit->code + jump_end - 4, &rel, sizeof(rel));
+}
+
+#define JZ  0x0F84
+#define JNZ 0x0F85
+#define JMP 0xE9
+
+static void emit_prologue(Jit_T jit)
+{
+        emit8(jit, 0x53);                               /* push rbx */
+        emit8(jit, 0x55);                               /* push rbp */
+        for (int r = 12; r <= 15; r++) {
+                emit8(jit, 0x41);                       /* push r12-r15 */
+                emit8(jit, 0x50 + (r & 7));
+        }
+        emit_rr(jit, true, 0x83, 5, RSP);               /* sub rsp, 8 */
+        emit8(jit, 8);
+        emit_rr(jit, true, 0x89, RDI, RBX);             /* rbx = registers */
+        emit_rr(jit, true, 0x89, RSI, RBP);             /* rbp = segments */
+        for (int i = 0; i < 8; i++) {
+                emit_mem(jit, false, 0x8B, UM(i), RBX, 4 * i);
+        }
+}
+
+static void emit_store_registers(Jit_T jit, int first, int last)
+{
+        for (int i = first; i <= last; i++) {
+                emit_mem(jit, false, 0x89, UM(i), RBX, 4 * i);
+        }
+}
+
+static void emit_load_registers(Jit_T jit, int first, int last)
+{
+        for (int i = first; i <= last; i++) {
+                emit_mem(jit, false, 0x8B, UM(i), RBX, 4 * i);
+        }
+}
+
+static void emit_return(Jit_T jit)
+{
+        emit_rr(jit, true, 0x83, 0, RSP);               /* add rsp, 8 */
+        emit8(jit, 8);
+        for (int r = 15; r >= 12; r--) {
+                emit8(jit, 0x41);                       /* pop r15-r12 */
+                emit8(jit, 0x58 + (r & 7));
+        }
+        emit8(jit, 0x5D);                               /* pop rbp */
+        emit8(jit, 0x5B);                               /* pop rbx */
+        emit8(jit, 0xC3);                               /* ret */
+}
+
+/* returns 'pc' having run the 'ran' instructions before it */
+static void emit_exit(Jit_T jit, uint32_t pc, uint32_t ran, uint64_t flags)
+{
+        emit_store_registers(jit, 0, 7);
+        emit8(jit, 0x48);                               /* mov rax, imm64 */
+        emit8(jit, 0xB8);
+        emit64(jit, pc | flags | (uint64_t)ran << RAN_SHIFT);
+        emit_return(jit);
+}
+
+/* rax = segments->mapped[id] */
+static void emit_segment_data(Jit_T jit, int id)
+{
+        emit_mem(jit, true, 0x8B, RAX, RBP, SEGMENT_FIELD(mapped));
+        emit_rr(jit, false, 0x89, id, RCX);
+        emit_sib(jit, true, 0x8B, RAX, RAX, RCX, 3);
+}
+
+static void emit_sstore(Jit_T jit, Instruction ins, uint32_t pc,
+                        uint32_t start)
+{
+        int a = UM(ins.a), b = UM(ins.b), c = UM(ins.c);
+
+        emit_rr(jit, false, 0x85, a, a);                /* test a, a */
+        size_t to_program = emit_jump(jit, JZ);
+
+        emit_segment_data(jit, a);
+        emit_mem(jit, false, 0x83, 7, RAX, -8);         /* cmp refcount, 1 */
+        emit8(jit, 1);
+        size_t to_shared = emit_jump(jit, JNZ);
+        emit_rr(jit, false, 0x89, b, RCX);
+        emit_sib(jit, false, 0x89, c, RAX, RCX, 2);
+        size_t stored = emit_jump(jit, JMP);
+
+        /* segment 0 (decoded and compiled copies must follow the write) or
+         * shared storage (copy first); r8-r11 are caller-saved */
+        patch(jit, to_program);
+        patch(jit, to_shared);
+        emit_store_registers(jit, 0, 3);
+        emit_rr(jit, true, 0x89, RBP, RDI);
+        emit_rr(jit, false, 0x89, a, RSI);
+        emit_rr(jit, false, 0x89, b, RDX);
+        emit_rr(jit, false, 0x89, c, RCX);
+        emit8(jit, 0x48);                               /* mov rax, imm64 */
+        emit8(jit, 0xB8);
+        emit64(jit, (uint64_t)(uintptr_t)sstore_slow);
+        emit_rr(jit, false, 0xFF, 2, RAX);              /* call rax */
+        emit_load_registers(jit, 0, 3);
+        emit_rr(jit, false, 0x85, RAX, RAX);
+        size_t still_valid = emit_jump(jit, JZ);
+        emit_exit(jit, pc + 1, pc + 1 - start, 0);
+
+        patch(jit, stored);
+        patch(jit, still_valid);
+}
+
+/* 'start' is the pc the block begins at */
+static void emit_instruction(Jit_T jit, Instruction ins, uint32_t pc,
+                             uint32_t start)
+{
+        int a = UM(ins.a), b = UM(ins.b), c = UM(ins.c);
+
+        switch (ins.op) {
+        case CMOV:
+                emit_rr(jit, false, 0x85, c, c);        /* test c, c */
+                emit_rr(jit, false, 0x0F45, a, b);      /* cmovne a, b */
+                break;
+        case SLOAD:
+                emit_segment_data(jit, b);
+                emit_rr(jit, false, 0x89, c, RCX);
+                emit_sib(jit, false, 0x8B, a, RAX, RCX, 2);
+                break;
+        case SSTORE:
+                emit_sstore(jit, ins, pc, start);
+                break;
+        case ADD:
+                emit_rr(jit, false, 0x89, b, RAX);
+                emit_rr(jit, false, 0x01, c, RAX);
+                emit_rr(jit, false, 0x89, RAX, a);
+                break;
+        case MULT:
+                emit_rr(jit, false, 0x89, b, RAX);
+                emit_rr(jit, false, 0x0FAF, RAX, c);    /* imul eax, c */
+                emit_rr(jit, false, 0x89, RAX, a);
+                break;
+        case DIV:
+                emit_rr(jit, false, 0x89, b, RAX);
+                emit_rr(jit, false, 0x31, RDX, RDX);
+                emit_rr(jit, false, 0xF7, 6, c);        /* div c */
+                emit_rr(jit, false, 0x89, RAX, a);
+                break;
+        case NAND:
+                emit_rr(jit, false, 0x89, b, RAX);
+                emit_rr(jit, false, 0x21, c, RAX);
+                emit_rr(jit, false, 0xF7, 2, RAX);      /* not eax */
+                emit_rr(jit, false, 0x89, RAX, a);
+                break;
+        case LOADV:
+                emit_mov_imm(jit, UM(ins.a), ins.value);
+                break;
+        case LOADP: {
+                /* only the jump is compiled; a real load goes back to
+                 * the interpreter, which counts it */
+                emit_rr(jit, false, 0x85, b, b);
+                size_t jump_only = emit_jump(jit, JZ);
+                emit_exit(jit, pc, pc - start, EXIT_TO_INTERPRETER);
+                patch(jit, jump_only);
+                emit_store_registers(jit, 0, 7);
+                emit8(jit, 0x48);                       /* mov rax, imm64 */
+                emit8(jit, 0xB8);
+                emit64(jit, (uint64_t)(pc + 1 - start) << RAN_SHIFT);
+                emit_rr(jit, true, 0x09, c, RAX);       /* or rax, c */
+                emit_return(jit);
+                break;
+        }
+        default:
+                assert(false);
+        }
+}
+
+static Block compile(Jit_T jit, Instruction* program, uint32_t start)
+{
+        if (ends_block(program[start].op) && program[start].op != LOADP) {
+                return INTERPRET;
+        }
+        if (CODE_SIZE - jit->used < (MAX_BLOCK + 2) * MAX_INSN_BYTES) {
+                jit_flush(jit, jit->length);
+        }
+
+        Block block = (Block)(uintptr_t)(jit->code + jit->used);
+        emit_prologue(jit);
+
+        uint32_t pc = start;
+        for (;;) {
+                if (pc == jit->length) {
+                        emit_exit(jit, pc, pc - start, EXIT_TO_INTERPRETER);
+                        break;
+                }
+                if (pc - start == MAX_BLOCK) {
+                        emit_exit(jit, pc, pc - start, 0);
+                        break;
+                }
+
+                Instruction ins = program[pc];
+                if (ins.op == LOADP) {
+                        emit_instruction(jit, ins, pc, start);
+                        jit->covered[pc++] = 1;
+                        break;
+                }
+                if (ends_block(ins.op)) {
+                        emit_exit(jit, pc, pc - start, EXIT_TO_INTERPRETER);
+                        break;
+                }
+                emit_instruction(jit, ins, pc, start);
+                jit->covered[pc++] = 1;
+        }
+
+        return block;
+}
+
+uint32_t jit_run(Segment_T segments, uint32_t* registers, uint32_t pc,
+                 uint64_t* steps, uint64_t limit)
+{
+        Jit_T jit = segments->jit;
+
+        for (;;) {
+                if (pc >= jit->length) {
+                        return pc;
+                }
+                Block block = jit->entry[pc];
+                if (block == NULL) {
+                        block = compile(jit, segments->program, pc);
+                        jit->entry[pc] = block;
+                }
+                if (block == INTERPRET) {
+                        return pc;
+                }
+
+                uint64_t next = block(registers, segments);
+                segments->dispatches++;
+                *steps += next >> RAN_SHIFT;
+                pc = (uint32_t)next;
+                sample_jump(segments, pc);
+                if ((next & EXIT_TO_INTERPRETER) ||
+                    __builtin_expect(*steps >= limit, 0)) {
+                        return pc;
+                }
+                if (__builtin_expect(checkpoint_due(*steps), 0)) {
+                        checkpoint_take(segments, registers, pc, *steps);
+                }
+        }
+}
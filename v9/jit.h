@@ -0,0 +1,40 @@
+/**************************************************************
+ *                        jit.h
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/16/2026
+ *
+ *       Summary:   x86-64 basic-block compiler for segment 0. Blocks
+ *                  run straight-line code with the UM registers held in
+ *                  r8d-r15d and hand control back to the interpreter at
+ *                  HALT, MAP, UNMAP, OUTPUT, INPUT and real LOADPs.
+ *         
+ **************************************************************/
+
+#ifndef JIT_H
+#define JIT_H
+
+#include <stdint.h>
+#include "segments.h"
+
+typedef struct Jit *Jit_T;
+
+Jit_T jit_new(void);
+
+void jit_free(Jit_T jit);
+
+/* drop every block; segment 0 is now 'length' words long */
+void jit_flush(Jit_T jit, uint32_t length);
+
+/* segment 0 word 'offset' is about to change; 'program' is still the old
+ * decoded segment 0 */
+void jit_invalidate(Jit_T jit, Instruction* program, uint32_t offset);
+
+/* run compiled blocks from 'pc', adding the instructions they ran to
+ * 'steps', until one needs the interpreter or 'steps' reaches 'limit';
+ * returns the pc of the next instruction to execute */
+uint32_t jit_run(Segment_T segments, uint32_t* registers, uint32_t pc,
+                 uint64_t* steps, uint64_t limit);
+
+#endif
@@ -0,0 +1,129 @@
+/**************************************************************
+ *                        libum.c
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   libum on top of execute_for: a machine is its
+ *                  segments plus the registers and pc between slices.
+ *
+ **************************************************************/
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include "libum.h"
+#include "segments.h"
+#include "execute.h"
+#include "load.h"
+#include "snapshot.h"
+
+#if UM_WOULD_BLOCK != IO_BLOCKED
+#error "UM_WOULD_BLOCK must match IO_BLOCKED"
+#endif
+
+/**************************************************************
+ * The Um struct consists of:
+ *      - segments: the loaded machine, NULL before um_load_image.
+ *      - io: its I/O, kept across loads and lent to segments.
+ *      - registers/pc: where the last slice stopped.
+ *      - steps: instructions run since the load.
+ *************************************************************/
+struct Um {
+        Segment_T segments;
+        Io_T io;
+        uint32_t registers[8];
+        uint32_t pc;
+        uint64_t steps;
+};
+
+Um_T um_create(void)
+{
+        Um_T vm = calloc(1, sizeof(*vm));
+        vm->io = io_new_fd(STDIN_FILENO, STDOUT_FILENO);
+        return vm;
+}
+
+/* segment_deinit frees segments->io, which belongs to the Um */
+static void unload(Um_T vm)
+{
+        if (vm->segments != NULL) {
+                vm->segments->io = NULL;
+                segment_deinit(vm->segments);
+                vm->segments = NULL;
+        }
+}
+
+void um_destroy(Um_T vm)
+{
+        unload(vm);
+        io_free(vm->io);
+        free(vm);
+}
+
+bool um_load_image(Um_T vm, const void* image, size_t length)
+{
+        if (length / sizeof(uint32_t) > UINT32_MAX) {
+                return false;
+        }
+        unload(vm);
+        vm->segments = load_image(image, length);
+        vm->segments->io = vm->io;
+        memset(vm->registers, 0, sizeof(vm->registers));
+        vm->pc = 0;
+        vm->steps = 0;
+        return true;
+}
+
+bool um_restore(Um_T vm, const char* path)
+{
+        uint32_t registers[8];
+        uint32_t pc;
+        Segment_T segments = snapshot_load(path, 0, registers, &pc);
+        if (segments == NULL) {
+                return false;
+        }
+        unload(vm);
+        vm->segments = segments;
+        vm->segments->io = vm->io;
+        memcpy(vm->registers, registers, sizeof(registers));
+        vm->pc = pc;
+        vm->steps = 0;
+        return true;
+}
+
+void um_set_io(Um_T vm, Um_read read, void* source, Um_write write,
+               void* sink)
+{
+        io_free(vm->io);
+        vm->io = io_new(read, source, write, sink);
+        if (vm->segments != NULL) {
+                vm->segments->io = vm->io;
+        }
+}
+
+Um_status um_run(Um_T vm, uint64_t max_instructions)
+{
+        if (vm->segments == NULL) {
+                return UM_FAULT;
+        }
+
+        switch (execute_for(vm->segments, vm->registers, &vm->pc,
+                            &vm->steps, max_instructions)) {
+        case EXEC_HALTED:
+                return UM_HALTED;
+        case EXEC_BLOCKED:
+                return UM_BLOCKED;
+        case EXEC_BUDGET:
+                return UM_BUDGET;
+        default:
+                return UM_FAULT;
+        }
+}
+
+uint64_t um_instructions(Um_T vm)
+{
+        return vm->steps;
+}
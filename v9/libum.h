@@ -0,0 +1,79 @@
+/**************************************************************
+ *                        libum.h
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   libum, the UM as a library (libum.a, libum.so) for
+ *                  programs that run machines themselves instead of
+ *                  starting a um process per program.
+ *
+ *                  A machine runs in slices: um_run returns after at
+ *                  most about 'max_instructions' instructions, or
+ *                  earlier when it halts, faults or wants input that
+ *                  isn't there yet, and the next um_run carries on.
+ *                  Input and output go through callbacks; without
+ *                  um_set_io a machine uses stdin and stdout.
+ *
+ *                  A machine must not be run by two threads at once;
+ *                  different machines are independent.
+ *
+ **************************************************************/
+
+#ifndef LIBUM_H
+#define LIBUM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/types.h>
+
+typedef struct Um *Um_T;
+
+typedef enum {
+        UM_HALTED,      /* ran HALT; running it again halts again */
+        UM_BLOCKED,     /* at an INPUT the read callback had no input for
+                         * (UM_WOULD_BLOCK); run again once it has */
+        UM_BUDGET,      /* ran its instructions for this slice */
+        UM_FAULT        /* invalid instruction, jump outside segment 0,
+                         * or no image loaded */
+} Um_status;
+
+/* what a read callback returns when no input is ready yet */
+#define UM_WOULD_BLOCK (-2)
+
+/* fill 'buffer' with up to 'size' bytes; 0 at end of input */
+typedef ssize_t (*Um_read)(void* source, unsigned char* buffer,
+                           size_t size);
+
+/* consume all 'length' bytes */
+typedef void (*Um_write)(void* sink, const unsigned char* bytes,
+                         size_t length);
+
+Um_T um_create(void);
+
+/* flushes output, then frees the machine */
+void um_destroy(Um_T vm);
+
+/* start over with the 'length' byte program at 'image' (big-endian words,
+ * as in a .um file); false if it is too big to be a UM program */
+bool um_load_image(Um_T vm, const void* image, size_t length);
+
+/* start over from a snapshot written by `um --checkpoint`; it is mapped
+ * copy-on-write, so machines restored from one file share its memory
+ * until they write to it. false if it can't be loaded. */
+bool um_restore(Um_T vm, const char* path);
+
+/* send input and output through these callbacks from now on */
+void um_set_io(Um_T vm, Um_read read, void* source, Um_write write,
+               void* sink);
+
+/* run until one of the Um_status events; the budget is checked at jumps,
+ * so a slice may run a little past it. Output is flushed on return. */
+Um_status um_run(Um_T vm, uint64_t max_instructions);
+
+/* instructions run since the image was loaded */
+uint64_t um_instructions(Um_T vm);
+
+#endif
@@ -0,0 +1,120 @@
+/**************************************************************
+ *                        load.c
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   mmap program loader and the byte-swap kernels it
+ *                  picks between at run time.
+ *
+ **************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "load.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_SWAP 1
+#endif
+
+static void swap_scalar(uint32_t* dst, const uint8_t* src, size_t count)
+{
+        for (size_t i = 0; i < count; i++) {
+                uint32_t word;
+                memcpy(&word, src + 4 * i, sizeof(word));
+                dst[i] = __builtin_bswap32(word);
+        }
+}
+
+#ifdef SIMD_SWAP
+
+__attribute__((target("ssse3")))
+static void swap_ssse3(uint32_t* dst, const uint8_t* src, size_t count)
+{
+        const __m128i reverse = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4,
+                                              11, 10, 9, 8, 15, 14, 13, 12);
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+                __m128i v = _mm_loadu_si128((const __m128i*)(src + 4 * i));
+                _mm_storeu_si128((__m128i*)(dst + i),
+                                 _mm_shuffle_epi8(v, reverse));
+        }
+        swap_scalar(dst + i, src + 4 * i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void swap_avx2(uint32_t* dst, const uint8_t* src, size_t count)
+{
+        const __m256i reverse = _mm256_setr_epi8(
+                3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+                __m256i v = _mm256_loadu_si256((const __m256i*)(src + 4 * i));
+                _mm256_storeu_si256((__m256i*)(dst + i),
+                                    _mm256_shuffle_epi8(v, reverse));
+        }
+        swap_scalar(dst + i, src + 4 * i, count - i);
+}
+
+#endif
+
+void swap_words(uint32_t* dst, const void* src, size_t count)
+{
+#ifdef SIMD_SWAP
+        if (__builtin_cpu_supports("avx2")) {
+                swap_avx2(dst, src, count);
+                return;
+        }
+        if (__builtin_cpu_supports("ssse3")) {
+                swap_ssse3(dst, src, count);
+                return;
+        }
+#endif
+        swap_scalar(dst, src, count);
+}
+
+Segment_T load_image(const void* image, size_t bytes)
+{
+        uint32_t num_words = bytes / sizeof(uint32_t);
+        Segment_T segments = segment_init(num_words);
+        swap_words(segments->mapped[0], image, num_words);
+        decode_program(segments);
+        return segments;
+}
+
+Segment_T load_program(const char* path)
+{
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+                return NULL;
+        }
+        struct stat fileStat;
+        if (fstat(fd, &fileStat) != 0) {
+                close(fd);
+                return NULL;
+        }
+
+        size_t bytes = fileStat.st_size;
+        if (bytes < sizeof(uint32_t)) {
+                close(fd);
+                return load_image(NULL, 0);
+        }
+        void* image = mmap(NULL, bytes, PROT_READ,
+                           MAP_PRIVATE | MAP_POPULATE, fd, 0);
+        close(fd);
+        if (image == MAP_FAILED) {
+                return NULL;
+        }
+        Segment_T segments = load_image(image, bytes);
+        munmap(image, bytes);
+        return segments;
+}
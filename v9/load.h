@@ -0,0 +1,33 @@
+/**************************************************************
+ *                        load.h
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   Program loader. The image file is mmapped and its
+ *                  big-endian words are byte-swapped straight into
+ *                  segment 0, 32 or 16 bytes at a time when the CPU
+ *                  has AVX2 or SSSE3.
+ *
+ **************************************************************/
+
+#ifndef LOAD_H
+#define LOAD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "segments.h"
+
+/* dst[i] = big-endian word i of src; dst and src may be unaligned */
+void swap_words(uint32_t* dst, const void* src, size_t count);
+
+/* segments with the 'bytes' long image at 'image' (big-endian words, as
+ * in a .um file) decoded as segment 0; a trailing partial word is
+ * ignored */
+Segment_T load_image(const void* image, size_t bytes);
+
+/* load_image of the file at 'path', or NULL if it can't be read */
+Segment_T load_program(const char* path);
+
+#endif
@@ -0,0 +1,73 @@
+/**************************************************************
+ *                        pool.c
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   Setup, teardown and statistics for the segment
+ *                  size-class allocator; the hot paths are inline in
+ *                  pool.h.
+ *
+ **************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "pool.h"
+
+Pool_T pool_init(void)
+{
+        Pool_T pool = calloc(1, sizeof(*pool));
+        return pool;
+}
+
+static void free_list(Free_block* block)
+{
+        while (block != NULL) {
+                Free_block* next = block->next;
+                free(block);
+                block = next;
+        }
+}
+
+void pool_deinit(Pool_T pool)
+{
+        for (unsigned class = 0; class < POOL_CLASSES; class++) {
+                free_list(pool->free[class]);
+        }
+        free(pool);
+}
+
+#ifdef UM_PROFILE
+
+void pool_report(Pool_T pool, FILE* out)
+{
+        fprintf(out, "segment pool:\n%10s %10s %12s %9s\n",
+                "class", "words", "requests", "hit rate");
+        for (unsigned class = 0; class <= POOL_UNPOOLED; class++) {
+                if (pool->requests[class] == 0) {
+                        continue;
+                }
+                double rate = 100.0 * pool->hits[class] /
+                              pool->requests[class];
+                if (class == POOL_UNPOOLED) {
+                        fprintf(out, "%10s %10s", "malloc", "-");
+                } else {
+                        fprintf(out, "%10u %10zu", class,
+                                pool_class_words(class));
+                }
+                fprintf(out, " %12llu %8.2f%%\n",
+                        (unsigned long long)pool->requests[class], rate);
+        }
+}
+
+#else
+
+void pool_report(Pool_T pool, FILE* out)
+{
+        (void)pool;
+        (void)out;
+}
+
+#endif
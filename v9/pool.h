@@ -0,0 +1,121 @@
+/**************************************************************
+ *                        pool.h
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   Size-class allocator for segment storage. Freed
+ *                  blocks go on a per-class free list and are handed
+ *                  out again by the next MAP of that class instead of
+ *                  going back to malloc.
+ *
+ *                  Classes are exact for up to 64 words (where nearly
+ *                  every sandmark/advent MAP falls) and powers of two
+ *                  up to 64K words; bigger blocks use malloc directly.
+ *
+ **************************************************************/
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#define POOL_SMALL_SHIFT 6
+#define POOL_SMALL_WORDS (1u << POOL_SMALL_SHIFT)
+#define POOL_MAX_SHIFT 16
+#define POOL_CLASSES (POOL_SMALL_WORDS + 1 + POOL_MAX_SHIFT - POOL_SMALL_SHIFT)
+#define POOL_UNPOOLED POOL_CLASSES
+
+/* a free block's first bytes link it to the next one in its class */
+typedef struct Free_block {
+        struct Free_block* next;
+} Free_block;
+
+/**************************************************************
+ * The Pool_T struct consists of:
+ *      - free: per-class free lists of blocks.
+ *      - requests/hits: per class, how many blocks were asked for and
+ *        how many came off the free list (profile builds only); the
+ *        extra last slot counts unpooled sizes.
+ *************************************************************/
+typedef struct {
+        Free_block* free[POOL_CLASSES];
+#ifdef UM_PROFILE
+        uint64_t requests[POOL_CLASSES + 1];
+        uint64_t hits[POOL_CLASSES + 1];
+#endif
+} *Pool_T;
+
+#ifdef UM_PROFILE
+#define POOL_COUNT(pool, class, hit) \
+        ((pool)->requests[class]++, (pool)->hits[class] += (hit))
+#else
+#define POOL_COUNT(pool, class, hit) ((void)0)
+#endif
+
+Pool_T pool_init(void);
+
+/* frees every cached block */
+void pool_deinit(Pool_T pool);
+
+/* per-class hit rates, profile builds only */
+void pool_report(Pool_T pool, FILE* out);
+
+static inline unsigned pool_class(uint32_t words)
+{
+        if (words <= POOL_SMALL_WORDS) {
+                return words;
+        }
+        if (words > (1u << POOL_MAX_SHIFT)) {
+                return POOL_UNPOOLED;
+        }
+        return POOL_SMALL_WORDS + (32 - __builtin_clz(words - 1)) -
+               POOL_SMALL_SHIFT;
+}
+
+/* words actually allocated for a class; at least a Free_block's worth */
+static inline size_t pool_class_words(unsigned class)
+{
+        if (class <= POOL_SMALL_WORDS) {
+                size_t min = sizeof(Free_block) / sizeof(uint32_t);
+                return class < min ? min : class;
+        }
+        return (size_t)1 << (class - POOL_SMALL_WORDS + POOL_SMALL_SHIFT);
+}
+
+/* uninitialized block of at least 'words' words */
+static inline uint32_t* pool_get(Pool_T pool, uint32_t words)
+{
+        unsigned class = pool_class(words);
+        if (class == POOL_UNPOOLED) {
+                POOL_COUNT(pool, POOL_UNPOOLED, 0);
+                return malloc(sizeof(uint32_t) * words);
+        }
+
+        Free_block* block = pool->free[class];
+        POOL_COUNT(pool, class, block != NULL);
+        if (block == NULL) {
+                return malloc(sizeof(uint32_t) * pool_class_words(class));
+        }
+        pool->free[class] = block->next;
+        return (uint32_t*)block;
+}
+
+/* return a block from pool_get(pool, words) */
+static inline void pool_put(Pool_T pool, uint32_t* data, uint32_t words)
+{
+        unsigned class = pool_class(words);
+        if (class == POOL_UNPOOLED) {
+                free(data);
+                return;
+        }
+
+        Free_block* block = (Free_block*)data;
+        block->next = pool->free[class];
+        pool->free[class] = block;
+}
+
+#endif
@@ -0,0 +1,143 @@
+/**************************************************************
+ *                        sample.c
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   SIGPROF sampling of the UM program counter, and the
+ *                  collapsed-stack report.
+ *
+ **************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include "sample.h"
+#include "instructions.h"
+
+/* 2^20 samples: over 17 minutes of CPU time at 997 Hz */
+#define RING_SIZE (1u << 20)
+
+/* runs are grouped into ranges of this many words */
+#define RANGE_WORDS 256
+
+/* the machine being sampled */
+static Segment_T sampled;
+
+/*
+ * Single-producer ring: the signal handler adds at 'head', the reader
+ * takes from 'tail'. A sample that finds the ring full is dropped.
+ * Each entry is the program number in the high half, the pc in the low.
+ */
+static uint64_t* ring;
+static uint32_t head, tail;
+static uint64_t dropped;
+static timer_t timer;
+static bool sampling = false;
+
+static void take_sample(int signal)
+{
+        (void)signal;
+        uint32_t at = __atomic_load_n(&head, __ATOMIC_RELAXED);
+        if (at - __atomic_load_n(&tail, __ATOMIC_ACQUIRE) == RING_SIZE) {
+                dropped++;
+                return;
+        }
+        ring[at % RING_SIZE] = (uint64_t)sampled->sample_program << 32 |
+                               sampled->sample_pc;
+        __atomic_store_n(&head, at + 1, __ATOMIC_RELEASE);
+}
+
+bool sample_start(Segment_T segments, unsigned hz)
+{
+        ring = malloc(sizeof(uint64_t) * RING_SIZE);
+        if (ring == NULL || hz == 0) {
+                return false;
+        }
+        sampled = segments;
+
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = take_sample;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGPROF, &action, NULL);
+
+        struct sigevent event;
+        memset(&event, 0, sizeof(event));
+        event.sigev_notify = SIGEV_SIGNAL;
+        event.sigev_signo = SIGPROF;
+        if (timer_create(CLOCK_PROCESS_CPUTIME_ID, &event, &timer) != 0) {
+                return false;
+        }
+        long interval = 1000000000L / hz;
+        struct itimerspec every = {
+                { interval / 1000000000L, interval % 1000000000L },
+                { interval / 1000000000L, interval % 1000000000L }
+        };
+        timer_settime(timer, 0, &every, NULL);
+        sampling = true;
+        return true;
+}
+
+static int compare(const void* a, const void* b)
+{
+        uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+        return (x > y) - (x < y);
+}
+
+/* last word of the run starting at 'pc' in the current program */
+static uint32_t run_end(Segment_T segments, uint32_t pc)
+{
+        uint32_t length = segment_length(segments->mapped[0]);
+        while (pc < length && base_op(segments->program[pc].op) != LOADP &&
+               base_op(segments->program[pc].op) != HALT) {
+                pc++;
+        }
+        return pc;
+}
+
+void sample_report(Segment_T segments, FILE* out)
+{
+        if (!sampling) {
+                return;
+        }
+        timer_delete(timer);
+        signal(SIGPROF, SIG_IGN);
+        sampling = false;
+
+        uint32_t count = head - tail;
+        uint64_t* samples = malloc(sizeof(uint64_t) * (count > 0 ? count : 1));
+        for (uint32_t i = 0; i < count; i++) {
+                samples[i] = ring[(tail + i) % RING_SIZE];
+        }
+        tail = head;
+        qsort(samples, count, sizeof(uint64_t), compare);
+
+        for (uint32_t i = 0, next; i < count; i = next) {
+                for (next = i + 1; next < count &&
+                     samples[next] == samples[i]; next++) {
+                }
+                uint32_t program = samples[i] >> 32;
+                uint32_t pc = (uint32_t)samples[i];
+                uint32_t range = pc - pc % RANGE_WORDS;
+
+                fprintf(out, "program %u;0x%06x-0x%06x;0x%06x", program,
+                        range, range + RANGE_WORDS - 1, pc);
+                if (program == segments->sample_program) {
+                        fprintf(out, "-0x%06x", run_end(segments, pc));
+                }
+                fprintf(out, " %u\n", next - i);
+        }
+        if (dropped > 0) {
+                fprintf(stderr, "sample: %llu samples dropped, ring full\n",
+                        (unsigned long long)dropped);
+        }
+        free(samples);
+        free(ring);
+}
@@ -0,0 +1,60 @@
+/**************************************************************
+ *                        sample.h
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   Sampling profiler for UM programs (um --sample FILE),
+ *                  in builds with SAMPLE=1 only.
+ *
+ *                  The interpreter records, in the machine, the target
+ *                  of every jump and which program (segment 0 since its
+ *                  last LOADP) it is in. A SIGPROF timer copies both
+ *                  from the machine being sampled into a lock-
+ *                  free ring. The exact pc is never recorded, which
+ *                  would cost a store per instruction: as LOADP is the
+ *                  only branch, a sample stands for the straight-line
+ *                  run from the last target to the next LOADP. The
+ *                  report is collapsed stacks, for flamegraph.pl:
+ *                  program, 256-word range, run.
+ *
+ *                  Other builds compile the recording out, so the
+ *                  interpreter and JIT run exactly as without it.
+ *
+ **************************************************************/
+
+#ifndef SAMPLE_H
+#define SAMPLE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "segments.h"
+
+/* target of the last jump, and the number of programs loaded before the
+ * running one */
+#ifdef UM_SAMPLE
+static inline void sample_jump(Segment_T segments, uint32_t pc)
+{
+        segments->sample_pc = pc;
+}
+
+static inline void sample_load(Segment_T segments)
+{
+        segments->sample_program++;
+}
+#else
+#define sample_jump(segments, pc) ((void)0)
+#define sample_load(segments) ((void)0)
+#endif
+
+/* samples 'segments' 'hz' times a second of CPU time; false if the timer
+ * can't be set up */
+bool sample_start(Segment_T segments, unsigned hz);
+
+/* stops sampling and writes the collapsed stacks to 'out'; runs in the
+ * current program of 'segments' are shown with their end */
+void sample_report(Segment_T segments, FILE* out);
+
+#endif
@@ -0,0 +1,565 @@
+/**************************************************************
+ *                        sched.c
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   Worker threads, run queues and session states for
+ *                  the scheduler.
+ *
+ *                  A session is PARKED (on no queue), QUEUED, RUNNING,
+ *                  or WOKEN (running, and woken since it started, so a
+ *                  block at the end of the slice must not park it).
+ *                  sched_wake moves PARKED to QUEUED and RUNNING to
+ *                  WOKEN; everything else is done by the worker that
+ *                  holds the session.
+ *
+ **************************************************************/
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "sched.h"
+
+#define CACHE_LINE 64
+
+/* entries in a worker's run queue; a power of two */
+#define RUNQ_SIZE 256
+
+/* a worker looks at the global queue first every this many slices, so
+ * wakeups aren't starved by a busy run queue */
+#define GLOBAL_EVERY 61
+
+/* durations in ns, four buckets per power of two */
+#define BUCKETS 256
+
+enum { PARKED, QUEUED, RUNNING, WOKEN };
+
+struct Session {
+        Sched_T sched;
+        Um_T vm;
+        Sched_done done;
+        void* arg;
+        int state;
+        uint64_t queued_at;
+        Session_T next;
+};
+
+/**************************************************************
+ * The Worker struct consists of:
+ *      - head/tail/slots: its run queue. Entries are taken from head
+ *        by the worker or a thief (with a CAS) and added at tail by
+ *        the worker alone.
+ *      - ticks: slices started, for GLOBAL_EVERY.
+ *      - slices/parks/steals, run/wait and their maxima: statistics,
+ *        only written by the worker.
+ *************************************************************/
+typedef struct {
+        Sched_T sched;
+        unsigned id;
+        pthread_t thread;
+        uint32_t head;
+        uint32_t tail;
+        Session_T slots[RUNQ_SIZE];
+        uint64_t ticks;
+        uint64_t slices, parks, steals;
+        uint64_t run[BUCKETS], wait[BUCKETS];
+        uint64_t max_run, max_wait;
+} Worker;
+
+/**************************************************************
+ * The Sched struct consists of:
+ *      - workers/num_workers, slice: the threads and their budget.
+ *      - lock: guards the global queue, idle and stopping.
+ *      - global_head/global_tail/global_length: sessions woken from
+ *        outside, or pushed out of a full run queue.
+ *      - work: idle workers wait here; idle counts them.
+ *      - live/finished: sessions not done yet; sched_wait waits on
+ *        finished for it to reach 0.
+ *************************************************************/
+struct Sched {
+        Worker** workers;
+        unsigned num_workers;
+        uint64_t slice;
+        pthread_mutex_t lock;
+        Session_T global_head;
+        Session_T global_tail;
+        size_t global_length;
+        pthread_cond_t work;
+        unsigned idle;
+        bool stopping;
+        uint64_t live;
+        pthread_cond_t finished;
+};
+
+static uint64_t now_ns(void)
+{
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (uint64_t)now.tv_sec * 1000000000u + now.tv_nsec;
+}
+
+static unsigned bucket(uint64_t ns)
+{
+        if (ns < 4) {
+                return ns;
+        }
+        unsigned log = 63 - __builtin_clzll(ns);
+        return 4 * (log - 1) + ((ns >> (log - 2)) & 3);
+}
+
+/* smallest duration in bucket 'b' */
+static uint64_t bucket_floor(unsigned b)
+{
+        if (b < 4) {
+                return b;
+        }
+        return (uint64_t)(4 + b % 4) << (b / 4 - 1);
+}
+
+static void record(uint64_t* histogram, uint64_t* max, uint64_t ns)
+{
+        histogram[bucket(ns)]++;
+        if (ns > *max) {
+                *max = ns;
+        }
+}
+
+/* owner only; false if the queue is full */
+static bool runq_put(Worker* w, Session_T s)
+{
+        uint32_t head = __atomic_load_n(&w->head, __ATOMIC_ACQUIRE);
+        uint32_t tail = w->tail;
+        if (tail - head >= RUNQ_SIZE) {
+                return false;
+        }
+        __atomic_store_n(&w->slots[tail % RUNQ_SIZE], s, __ATOMIC_RELAXED);
+        __atomic_store_n(&w->tail, tail + 1, __ATOMIC_RELEASE);
+        return true;
+}
+
+/* take the oldest entry, or NULL; any thread */
+static Session_T runq_take(Worker* w)
+{
+        uint32_t head = __atomic_load_n(&w->head, __ATOMIC_ACQUIRE);
+        for (;;) {
+                uint32_t tail = __atomic_load_n(&w->tail, __ATOMIC_ACQUIRE);
+                if (head == tail) {
+                        return NULL;
+                }
+                Session_T s = __atomic_load_n(&w->slots[head % RUNQ_SIZE],
+                                              __ATOMIC_RELAXED);
+                if (__atomic_compare_exchange_n(&w->head, &head, head + 1,
+                                                false, __ATOMIC_ACQ_REL,
+                                                __ATOMIC_ACQUIRE)) {
+                        return s;
+                }
+        }
+}
+
+/* take the older half (rounded up) of 'w's queue into 'batch'; returns
+ * how many, 0 if it was empty */
+static uint32_t runq_grab(Worker* w, Session_T batch[RUNQ_SIZE / 2])
+{
+        for (;;) {
+                uint32_t head = __atomic_load_n(&w->head, __ATOMIC_ACQUIRE);
+                uint32_t tail = __atomic_load_n(&w->tail, __ATOMIC_ACQUIRE);
+                uint32_t n = tail - head;
+                n -= n / 2;
+                if (n > RUNQ_SIZE / 2) {
+                        continue;       /* head moved on between loads */
+                }
+                for (uint32_t i = 0; i < n; i++) {
+                        batch[i] = __atomic_load_n(
+                                &w->slots[(head + i) % RUNQ_SIZE],
+                                __ATOMIC_RELAXED);
+                }
+                if (__atomic_compare_exchange_n(&w->head, &head, head + n,
+                                                false, __ATOMIC_ACQ_REL,
+                                                __ATOMIC_ACQUIRE)) {
+                        return n;
+                }
+        }
+}
+
+/* wake a worker waiting for work, if there is one */
+static void notify(Sched_T sched)
+{
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&sched->idle, __ATOMIC_RELAXED) != 0) {
+                pthread_mutex_lock(&sched->lock);
+                pthread_cond_signal(&sched->work);
+                pthread_mutex_unlock(&sched->lock);
+        }
+}
+
+/* append 'n' sessions to the global queue */
+static void global_put(Sched_T sched, Session_T* batch, uint32_t n)
+{
+        for (uint32_t i = 0; i + 1 < n; i++) {
+                batch[i]->next = batch[i + 1];
+        }
+        batch[n - 1]->next = NULL;
+
+        pthread_mutex_lock(&sched->lock);
+        if (sched->global_tail == NULL) {
+                sched->global_head = batch[0];
+        } else {
+                sched->global_tail->next = batch[0];
+        }
+        sched->global_tail = batch[n - 1];
+        __atomic_store_n(&sched->global_length, sched->global_length + n,
+                         __ATOMIC_RELAXED);
+        if (sched->idle != 0) {
+                pthread_cond_signal(&sched->work);
+        }
+        pthread_mutex_unlock(&sched->lock);
+}
+
+/* run queue full: move its older half, and 's', to the global queue;
+ * false if thieves made room meanwhile */
+static bool runq_overflow(Worker* w, Session_T s)
+{
+        Session_T batch[RUNQ_SIZE / 2 + 1];
+        uint32_t head = __atomic_load_n(&w->head, __ATOMIC_ACQUIRE);
+        uint32_t n = (w->tail - head) / 2;
+        if (n != RUNQ_SIZE / 2) {
+                return false;
+        }
+        for (uint32_t i = 0; i < n; i++) {
+                batch[i] = w->slots[(head + i) % RUNQ_SIZE];
+        }
+        if (!__atomic_compare_exchange_n(&w->head, &head, head + n, false,
+                                         __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                return false;
+        }
+        batch[n] = s;
+        global_put(w->sched, batch, n + 1);
+        return true;
+}
+
+static void push_local(Worker* w, Session_T s)
+{
+        while (!runq_put(w, s)) {
+                if (runq_overflow(w, s)) {
+                        return;
+                }
+        }
+        notify(w->sched);
+}
+
+/* a fair share of the global queue: one to run, the rest onto 'w's run
+ * queue; NULL if it is empty */
+static Session_T global_take(Worker* w)
+{
+        Sched_T sched = w->sched;
+        pthread_mutex_lock(&sched->lock);
+        size_t n = sched->global_length / sched->num_workers + 1;
+        uint32_t room = RUNQ_SIZE - (w->tail -
+                        __atomic_load_n(&w->head, __ATOMIC_ACQUIRE));
+        if (n > sched->global_length) {
+                n = sched->global_length;
+        }
+        if (n > (size_t)room + 1) {
+                n = room + 1;
+        }
+
+        Session_T first = sched->global_head;
+        for (size_t i = 0; i < n; i++) {
+                Session_T s = sched->global_head;
+                sched->global_head = s->next;
+                if (i > 0) {
+                        runq_put(w, s);
+                }
+        }
+        if (sched->global_head == NULL) {
+                sched->global_tail = NULL;
+        }
+        __atomic_store_n(&sched->global_length, sched->global_length - n,
+                         __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&sched->lock);
+        return n == 0 ? NULL : first;
+}
+
+/* half of another worker's queue: one to run, the rest onto 'w's */
+static Session_T steal(Worker* w)
+{
+        Sched_T sched = w->sched;
+        Session_T batch[RUNQ_SIZE / 2];
+        for (unsigned i = 1; i < sched->num_workers; i++) {
+                Worker* victim = sched->workers[(w->id + i) %
+                                                sched->num_workers];
+                uint32_t n = runq_grab(victim, batch);
+                if (n != 0) {
+                        w->steals++;
+                        for (uint32_t k = 1; k < n; k++) {
+                                if (!runq_put(w, batch[k])) {
+                                        push_local(w, batch[k]);
+                                }
+                        }
+                        return batch[0];
+                }
+        }
+        return NULL;
+}
+
+static bool global_waiting(Sched_T sched)
+{
+        return __atomic_load_n(&sched->global_length, __ATOMIC_RELAXED) != 0;
+}
+
+static Session_T find_work(Worker* w)
+{
+        Session_T s = NULL;
+        if (++w->ticks % GLOBAL_EVERY == 0 && global_waiting(w->sched)) {
+                s = global_take(w);
+        }
+        if (s == NULL) {
+                s = runq_take(w);
+        }
+        if (s == NULL && global_waiting(w->sched)) {
+                s = global_take(w);
+        }
+        if (s == NULL) {
+                s = steal(w);
+        }
+        return s;
+}
+
+static bool any_queued(Sched_T sched)
+{
+        for (unsigned i = 0; i < sched->num_workers; i++) {
+                Worker* w = sched->workers[i];
+                if (__atomic_load_n(&w->head, __ATOMIC_ACQUIRE) !=
+                    __atomic_load_n(&w->tail, __ATOMIC_ACQUIRE)) {
+                        return true;
+                }
+        }
+        return sched->global_head != NULL;
+}
+
+/* nothing to run: sleep until there may be; false once stopping */
+static bool wait_for_work(Sched_T sched)
+{
+        pthread_mutex_lock(&sched->lock);
+        __atomic_add_fetch(&sched->idle, 1, __ATOMIC_SEQ_CST);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (!sched->stopping && !any_queued(sched)) {
+                pthread_cond_wait(&sched->work, &sched->lock);
+        }
+        __atomic_sub_fetch(&sched->idle, 1, __ATOMIC_SEQ_CST);
+        bool stopping = sched->stopping;
+        pthread_mutex_unlock(&sched->lock);
+        return !stopping;
+}
+
+static void finish(Session_T s, Um_status status)
+{
+        Sched_T sched = s->sched;
+        s->done(s->vm, status, s->arg);
+        free(s);
+        if (__atomic_sub_fetch(&sched->live, 1, __ATOMIC_ACQ_REL) == 0) {
+                pthread_mutex_lock(&sched->lock);
+                pthread_cond_broadcast(&sched->finished);
+                pthread_mutex_unlock(&sched->lock);
+        }
+}
+
+static void requeue(Worker* w, Session_T s, uint64_t now)
+{
+        s->queued_at = now;
+        __atomic_store_n(&s->state, QUEUED, __ATOMIC_RELEASE);
+        push_local(w, s);
+}
+
+static void run_slice(Worker* w, Session_T s)
+{
+        uint64_t start = now_ns();
+        record(w->wait, &w->max_wait, start - s->queued_at);
+        __atomic_store_n(&s->state, RUNNING, __ATOMIC_SEQ_CST);
+
+        Um_status status = um_run(s->vm, w->sched->slice);
+        uint64_t end = now_ns();
+        record(w->run, &w->max_run, end - start);
+        w->slices++;
+
+        if (status == UM_BUDGET) {
+                requeue(w, s, end);
+        } else if (status == UM_BLOCKED) {
+                int running = RUNNING;
+                if (__atomic_compare_exchange_n(&s->state, &running, PARKED,
+                                                false, __ATOMIC_SEQ_CST,
+                                                __ATOMIC_SEQ_CST)) {
+                        w->parks++;
+                } else {
+                        requeue(w, s, end);     /* woken while running */
+                }
+        } else {
+                finish(s, status);
+        }
+}
+
+static void* worker_main(void* argument)
+{
+        Worker* w = argument;
+        for (;;) {
+                Session_T s = find_work(w);
+                if (s != NULL) {
+                        run_slice(w, s);
+                } else if (!wait_for_work(w->sched)) {
+                        return NULL;
+                }
+        }
+}
+
+Sched_T sched_new(unsigned workers, uint64_t slice)
+{
+        Sched_T sched = calloc(1, sizeof(*sched));
+        sched->num_workers = workers;
+        sched->slice = slice;
+        pthread_mutex_init(&sched->lock, NULL);
+        pthread_cond_init(&sched->work, NULL);
+        pthread_cond_init(&sched->finished, NULL);
+
+        /* each worker on its own cache lines */
+        sched->workers = malloc(sizeof(Worker*) * workers);
+        for (unsigned i = 0; i < workers; i++) {
+                void* block;
+                if (posix_memalign(&block, CACHE_LINE, sizeof(Worker)) != 0) {
+                        return NULL;
+                }
+                memset(block, 0, sizeof(Worker));
+                sched->workers[i] = block;
+                sched->workers[i]->sched = sched;
+                sched->workers[i]->id = i;
+        }
+        for (unsigned i = 0; i < workers; i++) {
+                pthread_create(&sched->workers[i]->thread, NULL,
+                               worker_main, sched->workers[i]);
+        }
+        return sched;
+}
+
+void sched_free(Sched_T sched)
+{
+        sched_wait(sched);
+        pthread_mutex_lock(&sched->lock);
+        sched->stopping = true;
+        pthread_cond_broadcast(&sched->work);
+        pthread_mutex_unlock(&sched->lock);
+
+        /* a worker still running may look at any other's queue */
+        for (unsigned i = 0; i < sched->num_workers; i++) {
+                pthread_join(sched->workers[i]->thread, NULL);
+        }
+        for (unsigned i = 0; i < sched->num_workers; i++) {
+                free(sched->workers[i]);
+        }
+        free(sched->workers);
+        pthread_mutex_destroy(&sched->lock);
+        pthread_cond_destroy(&sched->work);
+        pthread_cond_destroy(&sched->finished);
+        free(sched);
+}
+
+Session_T sched_session(Sched_T sched, Um_T vm, Sched_done done,
+                        void* arg)
+{
+        Session_T s = malloc(sizeof(*s));
+        s->sched = sched;
+        s->vm = vm;
+        s->done = done;
+        s->arg = arg;
+        s->state = PARKED;
+        s->queued_at = 0;
+        s->next = NULL;
+        __atomic_add_fetch(&sched->live, 1, __ATOMIC_ACQ_REL);
+        return s;
+}
+
+void sched_wake(Session_T s)
+{
+        int state = __atomic_load_n(&s->state, __ATOMIC_SEQ_CST);
+        for (;;) {
+                if (state == PARKED) {
+                        if (__atomic_compare_exchange_n(&s->state, &state,
+                                        QUEUED, false, __ATOMIC_SEQ_CST,
+                                        __ATOMIC_SEQ_CST)) {
+                                s->queued_at = now_ns();
+                                global_put(s->sched, &s, 1);
+                                return;
+                        }
+                } else if (state == RUNNING) {
+                        if (__atomic_compare_exchange_n(&s->state, &state,
+                                        WOKEN, false, __ATOMIC_SEQ_CST,
+                                        __ATOMIC_SEQ_CST)) {
+                                return;
+                        }
+                } else {
+                        return;         /* it will run anyway */
+                }
+        }
+}
+
+void sched_wait(Sched_T sched)
+{
+        pthread_mutex_lock(&sched->lock);
+        while (__atomic_load_n(&sched->live, __ATOMIC_ACQUIRE) != 0) {
+                pthread_cond_wait(&sched->finished, &sched->lock);
+        }
+        pthread_mutex_unlock(&sched->lock);
+}
+
+/* p50, p99 (as bucket upper bounds) and max of a merged histogram */
+static void print_distribution(FILE* out, const char* title,
+                               const uint64_t* histogram, uint64_t max)
+{
+        uint64_t total = 0;
+        for (unsigned b = 0; b < BUCKETS; b++) {
+                total += histogram[b];
+        }
+        fprintf(out, "  %-12s", title);
+        static const double points[] = { 0.5, 0.99, 0.999 };
+        static const char* const names[] = { "p50", "p99", "p99.9" };
+        for (unsigned p = 0; p < 3; p++) {
+                uint64_t seen = 0;
+                unsigned b = 0;
+                while (b < BUCKETS - 1 &&
+                       (seen += histogram[b]) < points[p] * total) {
+                        b++;
+                }
+                uint64_t bound = bucket_floor(b + 1);
+                fprintf(out, " %s <= %.3f ms,", names[p],
+                        (bound < max ? bound : max) / 1e6);
+        }
+        fprintf(out, " max %.3f ms\n", max / 1e6);
+}
+
+void sched_report(Sched_T sched, FILE* out)
+{
+        uint64_t run[BUCKETS] = {0}, wait[BUCKETS] = {0};
+        uint64_t slices = 0, parks = 0, steals = 0, max_run = 0, max_wait = 0;
+        for (unsigned i = 0; i < sched->num_workers; i++) {
+                Worker* w = sched->workers[i];
+                for (unsigned b = 0; b < BUCKETS; b++) {
+                        run[b] += w->run[b];
+                        wait[b] += w->wait[b];
+                }
+                slices += w->slices;
+                parks += w->parks;
+                steals += w->steals;
+                max_run = w->max_run > max_run ? w->max_run : max_run;
+                max_wait = w->max_wait > max_wait ? w->max_wait : max_wait;
+        }
+        fprintf(out, "sched: %llu slices of %llu instructions on %u "
+                "workers, %llu parks, %llu steals\n",
+                (unsigned long long)slices, (unsigned long long)sched->slice,
+                sched->num_workers, (unsigned long long)parks,
+                (unsigned long long)steals);
+        print_distribution(out, "slice time", run, max_run);
+        print_distribution(out, "queue wait", wait, max_wait);
+}
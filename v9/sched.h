@@ -0,0 +1,62 @@
+/**************************************************************
+ *                        sched.h
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   Time-slicing scheduler for many libum machines on a
+ *                  fixed set of worker threads.
+ *
+ *                  A session runs one um_run slice at a time. After a
+ *                  slice that used up its budget it goes to the back of
+ *                  its worker's run queue; a worker with nothing to run
+ *                  steals half of another worker's queue. A session
+ *                  that blocks on INPUT is parked, off every queue,
+ *                  until sched_wake says its input has arrived.
+ *
+ *                  The run queues are fixed-size lock-free rings: only
+ *                  the owner adds, while the owner and thieves take
+ *                  from the front, so each worker round-robins its own
+ *                  sessions. Wakeups from other threads and queue
+ *                  overflow go through one locked global queue.
+ *
+ **************************************************************/
+
+#ifndef SCHED_H
+#define SCHED_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "libum.h"
+
+typedef struct Sched *Sched_T;
+typedef struct Session *Session_T;
+
+/* called on a worker thread once a session's machine halts or faults;
+ * the session is gone afterwards, but the machine is the caller's */
+typedef void (*Sched_done)(Um_T vm, Um_status status, void* arg);
+
+/* 'workers' threads running slices of 'slice' instructions; NULL if out
+ * of memory */
+Sched_T sched_new(unsigned workers, uint64_t slice);
+
+/* waits for every session to finish, then stops the workers */
+void sched_free(Sched_T sched);
+
+/* a session running 'vm', parked until its first sched_wake */
+Session_T sched_session(Sched_T sched, Um_T vm, Sched_done done,
+                        void* arg);
+
+/* make a parked session runnable, from any thread; a session woken while
+ * it runs is run again instead of being parked. Not after it is done. */
+void sched_wake(Session_T session);
+
+/* until every session has finished */
+void sched_wait(Sched_T sched);
+
+/* slices run, parks, steals, and the distribution of slice lengths and
+ * of the time sessions waited to run */
+void sched_report(Sched_T sched, FILE* out);
+
+#endif
@@ -0,0 +1,280 @@
+/**************************************************************
+ *                        segments.c
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       11/20/2023
+ *
+ *       Summary:   Contains functions for managing memory segments,
+ *                  including initialization, deallocation, creation,
+ *                  and manipulation of memory segments, and keeps the
+ *                  decoded (and compiled) forms of segment 0 coherent.
+ *         
+ **************************************************************/
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "segments.h"
+#include "io.h"
+#ifdef UM_JIT
+#include "jit.h"
+#endif
+
+/* ID tables start at one cache line of entries and double from there */
+#define CACHE_LINE 64
+#define INITIAL_CAPACITY (CACHE_LINE / sizeof(uint32_t*))
+
+/* like malloc, NULL on failure */
+static void* cache_aligned_alloc(size_t bytes)
+{
+        void* block;
+        if (posix_memalign(&block, CACHE_LINE, bytes) != 0) {
+                return NULL;
+        }
+        return block;
+}
+
+/* uninitialized, unshared segment of 'length' words */
+uint32_t* new_segment(Pool_T pool, uint32_t length)
+{
+        uint32_t* block = pool_get(pool, length + 2);
+        block[0] = 1;
+        block[1] = length;
+        return block + 2;
+}
+
+/* drop one reference; the last one returns the storage to the pool */
+void free_segment(Pool_T pool, uint32_t* segment)
+{
+        if (--segment[-2] == 0) {
+                pool_put(pool, segment - 2, segment_length(segment) + 2);
+        }
+}
+
+Segment_T segment_init(uint32_t num_words)
+{
+        Segment_T new_segments = malloc(sizeof(*new_segments));
+        new_segments->pool = pool_init();
+        
+        new_segments->capacity = INITIAL_CAPACITY;
+        new_segments->mapped = cache_aligned_alloc(sizeof(uint32_t*) *
+                                                   INITIAL_CAPACITY);
+        new_segments->mapped_length = 1;
+        new_segments->unmapped = cache_aligned_alloc(sizeof(uint32_t) *
+                                                     INITIAL_CAPACITY);
+        new_segments->unmapped_length = 0;
+        
+        new_segments->mapped[0] = new_segment(new_segments->pool, num_words);
+        new_segments->program = NULL;
+        new_segments->shared_bytes = 0;
+        new_segments->copied_bytes = 0;
+        new_segments->snapshot_copied_bytes = 0;
+        new_segments->dispatches = 0;
+        new_segments->snapshot = NULL;
+        new_segments->snapshot_size = 0;
+        new_segments->io = NULL;
+        new_segments->sample_pc = 0;
+        new_segments->sample_program = 0;
+#ifdef UM_JIT
+        new_segments->jit = jit_new();
+#endif
+
+        return new_segments;
+}
+
+/* the decoded program may live in a mapped snapshot */
+static void free_program(Segment_T segments)
+{
+        uint8_t* program = (uint8_t*)segments->program;
+        uint8_t* snapshot = segments->snapshot;
+        if (snapshot == NULL || program < snapshot ||
+            program >= snapshot + segments->snapshot_size) {
+                free(program);
+        }
+}
+
+void segment_deinit(Segment_T segments)
+{
+        for (uint32_t i = 0; i < segments->mapped_length; i++) {
+                uint32_t* segment = segments->mapped[i];
+                if (segment != NULL) {
+                        free_segment(segments->pool, segment);
+                }
+        }
+
+        free(segments->mapped);
+        free(segments->unmapped);
+        free_program(segments);
+#ifdef UM_JIT
+        jit_free(segments->jit);
+#endif
+        pool_deinit(segments->pool);
+        if (segments->snapshot != NULL) {
+                munmap(segments->snapshot, segments->snapshot_size);
+        }
+        if (segments->io != NULL) {
+                io_free(segments->io);
+        }
+        free(segments);
+}
+
+/* double both ID tables; unmapped never holds more than mapped_length IDs,
+ * so one capacity covers both */
+static void grow_tables(Segment_T segments)
+{
+        uint32_t capacity = segments->capacity * 2;
+
+        uint32_t** mapped = cache_aligned_alloc(sizeof(uint32_t*) * capacity);
+        memcpy(mapped, segments->mapped,
+               sizeof(uint32_t*) * segments->mapped_length);
+        free(segments->mapped);
+        segments->mapped = mapped;
+
+        uint32_t* unmapped = cache_aligned_alloc(sizeof(uint32_t) * capacity);
+        memcpy(unmapped, segments->unmapped,
+               sizeof(uint32_t) * segments->unmapped_length);
+        free(segments->unmapped);
+        segments->unmapped = unmapped;
+
+        segments->capacity = capacity;
+}
+
+void segment_reserve(Segment_T segments, uint32_t num_ids)
+{
+        while (segments->capacity < num_ids) {
+                grow_tables(segments);
+        }
+}
+
+uint32_t segment_new(Segment_T segments, uint32_t num_words)
+{
+        uint32_t id;
+        if (segments->unmapped_length != 0) {
+                id = segments->unmapped[segments->unmapped_length - 1];
+                segments->unmapped_length--;
+        } else {
+                if (segments->mapped_length == segments->capacity) {
+                        grow_tables(segments);
+                }
+                id = segments->mapped_length++;
+        }
+
+        segments->mapped[id] = new_segment(segments->pool, num_words);
+        memset(segments->mapped[id], 0, sizeof(uint32_t) * num_words);
+        
+        return id;
+}
+
+void segment_free(Segment_T segments, uint32_t segment_id)
+{
+        free_segment(segments->pool, segments->mapped[segment_id]);
+        segments->mapped[segment_id] = NULL;
+        segments->unmapped[segments->unmapped_length++] = segment_id;
+}
+
+void segment_duplicate(Segment_T segments, uint32_t segment_id)
+{
+        uint32_t* source = segments->mapped[segment_id];
+        source[-2]++;
+        free_segment(segments->pool, segments->mapped[0]);
+
+        /* shared until either side is written */
+        segments->mapped[0] = source;
+        segments->shared_bytes += sizeof(uint32_t) * segment_length(source);
+        decode_program(segments);
+}
+
+/* give 'segment_id' a private copy of storage it shares; returns it */
+uint32_t* segment_unshare(Segment_T segments, uint32_t segment_id)
+{
+        uint32_t* shared = segments->mapped[segment_id];
+        uint32_t len = segment_length(shared);
+        uint32_t* copy = new_segment(segments->pool, len);
+
+        memcpy(copy, shared, sizeof(uint32_t) * len);
+        if (shared[-2] >= SEGMENT_PINNED) {
+                segments->snapshot_copied_bytes += sizeof(uint32_t) * len;
+        } else {
+                segments->copied_bytes += sizeof(uint32_t) * len;
+        }
+        free_segment(segments->pool, shared);
+        segments->mapped[segment_id] = copy;
+
+        return copy;
+}
+
+void segment_report(Segment_T segments, FILE* out)
+{
+        uint64_t avoided = segments->shared_bytes > segments->copied_bytes ?
+                           segments->shared_bytes - segments->copied_bytes :
+                           0;
+        fprintf(out, "copy-on-write LOADP: %llu bytes shared, %llu copied "
+                "on a later write, %llu bytes of copying avoided\n",
+                (unsigned long long)segments->shared_bytes,
+                (unsigned long long)segments->copied_bytes,
+                (unsigned long long)avoided);
+        if (segments->snapshot_copied_bytes > 0) {
+                fprintf(out, "snapshot: %llu bytes copied out on a write\n",
+                        (unsigned long long)
+                        segments->snapshot_copied_bytes);
+        }
+        pool_report(segments->pool, out);
+}
+
+/* (re)build the decoded copy of segment 0, with an INVALID entry after
+ * the last word so that running off the end faults */
+void decode_program(Segment_T segments)
+{
+        uint32_t* words = segments->mapped[0];
+        uint32_t length = segment_length(words);
+
+        free_program(segments);
+        segments->program = malloc(sizeof(Instruction) * (length + 1));
+        for (uint32_t i = 0; i < length; i++) {
+                segments->program[i] = decode_word(words[i]);
+        }
+        segments->program[length] = (Instruction){ .op = INVALID };
+#ifdef UM_FUSE
+        for (uint32_t i = 0; i + 1 < length; i++) {
+                segments->program[i].op = fuse(segments->program[i].op,
+                                               segments->program[i + 1].op);
+        }
+#endif
+#ifdef UM_JIT
+        jit_flush(segments->jit, length);
+#endif
+}
+
+void use_program(Segment_T segments, Instruction* program)
+{
+        free_program(segments);
+        segments->program = program;
+#ifdef UM_JIT
+        jit_flush(segments->jit, segment_length(segments->mapped[0]));
+#endif
+}
+
+/* segment 0 word 'offset' now holds 'value': refresh its decoded entry */
+void program_write(Segment_T segments, uint32_t offset, uint32_t value)
+{
+#ifdef UM_JIT
+        /* must run first: it scans the still-old decoded words */
+        jit_invalidate(segments->jit, segments->program, offset);
+#endif
+        segments->program[offset] = decode_word(value);
+#ifdef UM_FUSE
+        /* the pairs starting here and one word back may have changed */
+        Instruction* program = segments->program;
+        if (offset + 1 < segment_length(segments->mapped[0])) {
+                program[offset].op = fuse(program[offset].op,
+                                          program[offset + 1].op);
+        }
+        if (offset > 0) {
+                program[offset - 1].op = fuse(program[offset - 1].op,
+                                              program[offset].op);
+        }
+#endif
+}
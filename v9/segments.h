@@ -0,0 +1,136 @@
+/**************************************************************
+ *                        segments.h
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       11/20/2023
+ *
+ *       Summary:   Header file for memory segment functions, including
+ *                  initialization, deallocation, creation, and manipulation
+ *                  of memory segments. Word access is static inline so
+ *                  SLOAD/SSTORE cost no call.
+ *         
+ **************************************************************/
+
+#ifndef SEGMENTS_H
+#define SEGMENTS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "instructions.h"
+#include "pool.h"
+
+/**************************************************************
+ * The Segment_T struct consists of:
+ *      - mapped: segment ID -> segment data, NULL when unmapped. Each
+ *        segment is one allocation laid out as [refcount, length,
+ *        data...]; mapped points at the data, so SLOAD/SSTORE are one
+ *        load from the table and one from the data. LOADP shares the
+ *        source's storage with segment 0 and the first SSTORE into
+ *        either side copies it (copy-on-write).
+ *      - unmapped: stack of freed IDs, reused LIFO.
+ *      - capacity: slots in both tables; doubles when IDs run out.
+ *      - pool: recycles segment storage across MAP/UNMAP.
+ *      - program: decoded copy of segment 0, kept in step with it.
+ *      - jit: compiled code for segment 0 (JIT builds only).
+ *      - shared_bytes/copied_bytes: bytes LOADP shared instead of
+ *        copying, and how many of those a later write copied anyway.
+ *      - snapshot_copied_bytes: bytes copied out of a snapshot by a
+ *        write, which LOADP had no part in.
+ *      - dispatches: trips through the interpreter's dispatch branch
+ *        and compiled blocks entered, so far; a superinstruction or a
+ *        block is one dispatch for several instructions.
+ *      - snapshot/snapshot_size: a MAP_PRIVATE snapshot file that
+ *        mapped entries may point into (see snapshot.h), or NULL.
+ *      - io: the machine's I/O channels (io.h), attached by whoever
+ *        runs it; freed (and flushed) by segment_deinit.
+ *************************************************************/
+typedef struct {
+        uint32_t** mapped;
+        uint32_t mapped_length;
+        uint32_t* unmapped;
+        uint32_t unmapped_length;
+        uint32_t capacity;
+        Pool_T pool;
+        Instruction* program;
+#ifdef UM_JIT
+        struct Jit* jit;
+#endif
+        uint64_t shared_bytes;
+        uint64_t copied_bytes;
+        uint64_t snapshot_copied_bytes;
+        uint64_t dispatches;
+        void* snapshot;
+        size_t snapshot_size;
+        struct Io* io;
+        /* for the profiler (sample.h), in SAMPLE=1 builds */
+        volatile uint32_t sample_pc;
+        volatile uint32_t sample_program;
+} *Segment_T;
+
+/* refcount of a segment that lives in a mapped snapshot: it reads as
+ * shared, so the first write copies it out, and never reaches 0, so it
+ * never goes to the pool */
+#define SEGMENT_PINNED (1u << 30)
+
+uint32_t* new_segment(Pool_T pool, uint32_t length);
+
+void free_segment(Pool_T pool, uint32_t* segment);
+
+static inline uint32_t segment_length(const uint32_t* segment)
+{
+        return segment[-1];
+}
+
+static inline bool segment_shared(const uint32_t* segment)
+{
+        return segment[-2] != 1;
+}
+
+Segment_T segment_init(uint32_t num_words);
+
+void segment_deinit(Segment_T segments);
+
+/* make room for IDs below 'num_ids' without further growth */
+void segment_reserve(Segment_T segments, uint32_t num_ids);
+
+uint32_t segment_new(Segment_T segments, uint32_t num_words);
+
+void segment_free(Segment_T segments, uint32_t segment_id);
+
+void segment_duplicate(Segment_T segments, uint32_t segment_id);
+
+void decode_program(Segment_T segments);
+
+/* like decode_program, with segment 0 already decoded into 'program' by
+ * this build */
+void use_program(Segment_T segments, Instruction* program);
+
+void program_write(Segment_T segments, uint32_t offset, uint32_t value);
+
+uint32_t* segment_unshare(Segment_T segments, uint32_t segment_id);
+
+/* copy-on-write and allocator statistics */
+void segment_report(Segment_T segments, FILE* out);
+
+static inline void segment_store_word(Segment_T segments, uint32_t segment_id,
+                                      uint32_t offset, uint32_t value)
+{
+        uint32_t* segment = segments->mapped[segment_id];
+        if (__builtin_expect(segment_shared(segment), 0)) {
+                segment = segment_unshare(segments, segment_id);
+        }
+        segment[offset] = value;
+        if (segment_id == 0) {
+                program_write(segments, offset, value);
+        }
+}
+
+static inline uint32_t segment_get_word(Segment_T segments,
+                                        uint32_t segment_id, uint32_t offset)
+{
+        return segments->mapped[segment_id][offset];
+}
+
+#endif
@@ -0,0 +1,264 @@
+/**************************************************************
+ *                        snapshot.c
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   Writing machine state files and mapping them back
+ *                  as the storage of a fresh Segment_T.
+ *
+ **************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "snapshot.h"
+
+/* how this build decodes segment 0 */
+#ifdef UM_FUSE
+#define DECODING 2
+#else
+#define DECODING 1
+#endif
+
+static uint64_t align(uint64_t offset, uint64_t to)
+{
+        return (offset + to - 1) & ~(to - 1);
+}
+
+static uint64_t index_start(uint32_t unmapped_length)
+{
+        return align(sizeof(Snapshot_header) +
+                     sizeof(uint32_t) * (uint64_t)unmapped_length, 8);
+}
+
+/* where the block of a 'length'-word segment goes, at or after 'offset' */
+static uint64_t block_start(uint64_t offset, uint32_t length)
+{
+        uint64_t bytes = sizeof(uint32_t) * ((uint64_t)length + 2);
+        return align(offset, bytes >= SNAPSHOT_PAGE ? SNAPSHOT_PAGE : 8);
+}
+
+static void pad(FILE* out, uint64_t offset)
+{
+        static const char zeros[SNAPSHOT_PAGE];
+        fwrite(zeros, 1, offset - ftell(out), out);
+}
+
+bool snapshot_save(const char* path, uint64_t key, Segment_T segments,
+                   const uint32_t registers[8], uint32_t pc)
+{
+        /* not mkstemp, whose 0600 would keep a cache directory shared
+         * between users from ever hitting: 0644 less the umask, under a
+         * name unique to this process and call */
+        static uint32_t saves = 0;
+        size_t path_length = strlen(path);
+        char* temp = malloc(path_length + 32);
+        snprintf(temp, path_length + 32, "%s.%ld.%u", path, (long)getpid(),
+                 __atomic_fetch_add(&saves, 1, __ATOMIC_RELAXED));
+        int fd = open(temp, O_WRONLY | O_CREAT | O_EXCL, 0644);
+        FILE* out = fd < 0 ? NULL : fdopen(fd, "wb");
+        if (out == NULL) {
+                free(temp);
+                return false;
+        }
+
+        uint32_t mapped_length = segments->mapped_length;
+        uint32_t unmapped_length = segments->unmapped_length;
+        Snapshot_header header = {
+                .key = key, .decoding = DECODING, .pc = pc,
+                .mapped_length = mapped_length,
+                .unmapped_length = unmapped_length
+        };
+        memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+        memcpy(header.registers, registers, sizeof(header.registers));
+        fwrite(&header, sizeof(header), 1, out);
+        fwrite(segments->unmapped, sizeof(uint32_t), unmapped_length, out);
+        pad(out, index_start(unmapped_length));
+
+        /* index first, then the blocks in the same order */
+        uint32_t* program = segments->mapped[0];
+        uint64_t offset = align(index_start(unmapped_length) +
+                                sizeof(Snapshot_entry) *
+                                (uint64_t)mapped_length, SNAPSHOT_PAGE);
+        uint64_t program_offset = 0;
+        for (uint32_t id = 0; id < mapped_length; id++) {
+                uint32_t* segment = segments->mapped[id];
+                Snapshot_entry entry = { 0 };
+                if (segment == program && id != 0) {
+                        entry.offset = program_offset;
+                } else if (segment != NULL) {
+                        uint32_t length = segment_length(segment);
+                        offset = block_start(offset, length);
+                        entry.offset = offset + 2 * sizeof(uint32_t);
+                        offset = entry.offset +
+                                 sizeof(uint32_t) * (uint64_t)length;
+                        if (id == 0) {
+                                program_offset = entry.offset;
+                        }
+                }
+                fwrite(&entry, sizeof(entry), 1, out);
+        }
+        pad(out, align(ftell(out), SNAPSHOT_PAGE));
+        for (uint32_t id = 0; id < mapped_length; id++) {
+                uint32_t* segment = segments->mapped[id];
+                if (segment == NULL || (segment == program && id != 0)) {
+                        continue;
+                }
+                uint32_t length = segment_length(segment);
+                pad(out, block_start(ftell(out), length));
+                uint32_t block[2] = { SEGMENT_PINNED, length };
+                fwrite(block, sizeof(uint32_t), 2, out);
+                fwrite(segment, sizeof(uint32_t), length, out);
+        }
+
+        pad(out, align(ftell(out), SNAPSHOT_PAGE));
+        header.program = ftell(out);
+        fwrite(segments->program, sizeof(Instruction),
+               segment_length(program) + 1, out);
+        fseek(out, 0, SEEK_SET);
+        fwrite(&header, sizeof(header), 1, out);
+
+        bool ok = !ferror(out);
+        ok = (fclose(out) == 0) && ok;
+        ok = ok && rename(temp, path) == 0;
+        if (!ok) {
+                unlink(temp);
+        }
+        free(temp);
+        return ok;
+}
+
+/* a block whose words start at 'offset' lies within the file */
+static bool valid_block(const uint8_t* file, uint64_t size, uint64_t offset)
+{
+        if (offset % 4 != 0 || offset < 2 * sizeof(uint32_t) ||
+            offset > size) {
+                return false;
+        }
+        const uint32_t* segment = (const uint32_t*)(file + offset);
+        return segment[-2] == SEGMENT_PINNED &&
+               sizeof(uint32_t) * (uint64_t)segment[-1] <= size - offset;
+}
+
+Segment_T snapshot_load(const char* path, uint64_t key,
+                        uint32_t registers[8], uint32_t* pc)
+{
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+                return NULL;
+        }
+        struct stat fileStat;
+        if (fstat(fd, &fileStat) != 0 ||
+            (uint64_t)fileStat.st_size < sizeof(Snapshot_header)) {
+                close(fd);
+                return NULL;
+        }
+        uint64_t size = fileStat.st_size;
+        uint8_t* file = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                             fd, 0);
+        close(fd);
+        if (file == MAP_FAILED) {
+                return NULL;
+        }
+
+        Snapshot_header header;
+        memcpy(&header, file, sizeof(header));
+        uint32_t mapped_length = header.mapped_length;
+        uint32_t unmapped_length = header.unmapped_length;
+        uint64_t start = index_start(unmapped_length);
+        const Snapshot_entry* index = (const Snapshot_entry*)(file + start);
+        bool valid =
+                memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) == 0 &&
+                (key == 0 || header.key == key) && mapped_length != 0 &&
+                unmapped_length <= mapped_length &&
+                start + sizeof(Snapshot_entry) * (uint64_t)mapped_length <= size &&
+                index[0].offset != 0;
+        for (uint32_t id = 0; valid && id < mapped_length; id++) {
+                valid = index[id].offset == 0 ||
+                        valid_block(file, size, index[id].offset);
+        }
+        if (!valid) {
+                munmap(file, size);
+                return NULL;
+        }
+
+        Segment_T segments = segment_init(0);
+        free_segment(segments->pool, segments->mapped[0]);
+        segment_reserve(segments, mapped_length);
+        for (uint32_t id = 0; id < mapped_length; id++) {
+                uint64_t offset = index[id].offset;
+                segments->mapped[id] = offset == 0 ? NULL :
+                                       (uint32_t*)(file + offset);
+        }
+        segments->mapped_length = mapped_length;
+        memcpy(segments->unmapped, file + sizeof(Snapshot_header),
+               sizeof(uint32_t) * unmapped_length);
+        segments->unmapped_length = unmapped_length;
+        segments->snapshot = file;
+        segments->snapshot_size = size;
+
+        memcpy(registers, header.registers, sizeof(header.registers));
+        *pc = header.pc;
+
+        uint64_t program_bytes = sizeof(Instruction) *
+                (segment_length(segments->mapped[0]) + (uint64_t)1);
+        if (header.decoding == DECODING && header.program != 0 &&
+            header.program % SNAPSHOT_PAGE == 0 && header.program <= size &&
+            program_bytes <= size - header.program) {
+                use_program(segments, (Instruction*)(file + header.program));
+        } else {
+                decode_program(segments);
+        }
+        return segments;
+}
+
+void snapshot_report(Segment_T segments, FILE* out)
+{
+        if (segments->snapshot == NULL) {
+                fprintf(out, "rss: no snapshot mapped\n");
+                return;
+        }
+        FILE* smaps = fopen("/proc/self/smaps", "r");
+        if (smaps == NULL) {
+                fprintf(out, "rss: /proc/self/smaps unavailable\n");
+                return;
+        }
+
+        /* the fields of the mapping that starts at the snapshot */
+        uintptr_t start = (uintptr_t)segments->snapshot;
+        unsigned long long rss = 0, pss = 0, private_kb = 0;
+        bool found = false;
+        char line[512];
+        while (fgets(line, sizeof(line), smaps) != NULL) {
+                unsigned long long from, to, kb;
+                char name[32];
+                if (sscanf(line, "%llx-%llx ", &from, &to) == 2) {
+                        if (found) {
+                                break;
+                        }
+                        found = from == start;
+                } else if (found && sscanf(line, "%31[A-Za-z_]: %llu kB",
+                                           name, &kb) == 2) {
+                        if (strcmp(name, "Rss") == 0) {
+                                rss = kb;
+                        } else if (strcmp(name, "Pss") == 0) {
+                                pss = kb;
+                        } else if (strncmp(name, "Private_", 8) == 0) {
+                                private_kb += kb;
+                        }
+                }
+        }
+        fclose(smaps);
+
+        fprintf(out, "rss: snapshot %zu kB mapped, %llu kB resident, "
+                "%llu kB private; %llu kB saved by sharing (rss - pss)\n",
+                segments->snapshot_size / 1024, rss, private_kb,
+                rss - pss);
+}
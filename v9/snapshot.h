@@ -0,0 +1,77 @@
+/**************************************************************
+ *                        snapshot.h
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   Machine state files: the whole segment table (live
+ *                  segments and the free-ID list), the registers and
+ *                  the program counter.
+ *
+ *                  A snapshot is loaded by mapping it MAP_PRIVATE and
+ *                  pointing the segment table straight into the
+ *                  mapping, so any number of processes restoring the
+ *                  same file share its pages, nothing is read until it
+ *                  is touched, and a segment is copied out only when
+ *                  written (its refcount is SEGMENT_PINNED).
+ *
+ *                  Layout, in host byte order: a Snapshot_header, the
+ *                  free IDs, one Snapshot_entry per ID, then, from the
+ *                  next page, each live segment as it sits in memory:
+ *                  [refcount, length, words...]. Blocks are 8-byte
+ *                  aligned, and those of a page or more start on a page
+ *                  so that writes to them don't unshare their
+ *                  neighbours. A segment sharing segment 0's storage
+ *                  (after a LOADP) has segment 0's offset.
+ *
+ *                  Segment 0's decoded form, end marker included,
+ *                  follows on its own pages, tagged with how it was
+ *                  decoded (fused or not); a build that decodes the
+ *                  same way maps it instead of decoding again.
+ *
+ **************************************************************/
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "segments.h"
+
+#define SNAPSHOT_MAGIC "UMSNAP03"
+#define SNAPSHOT_PAGE 4096
+
+typedef struct {
+        char magic[8];
+        uint64_t key;
+        uint64_t program;
+        uint32_t decoding;
+        uint32_t registers[8];
+        uint32_t pc;
+        uint32_t mapped_length;
+        uint32_t unmapped_length;
+} Snapshot_header;
+
+/* offset of the segment's words (just past its refcount and length), or
+ * 0 for an unmapped ID */
+typedef struct {
+        uint64_t offset;
+} Snapshot_entry;
+
+/* write the machine to 'path' (via a temporary file and rename); 'key' is
+ * stored for the caller to check on load */
+bool snapshot_save(const char* path, uint64_t key, Segment_T segments,
+                   const uint32_t registers[8], uint32_t pc);
+
+/* the machine saved in 'path', or NULL if it is missing, malformed or
+ * was saved with a different key (unless 'key' is 0) */
+Segment_T snapshot_load(const char* path, uint64_t key,
+                        uint32_t registers[8], uint32_t* pc);
+
+/* resident memory of the mapped snapshot behind 'segments', and how much
+ * of it is shared with other processes rather than private */
+void snapshot_report(Segment_T segments, FILE* out);
+
+#endif
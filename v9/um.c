@@ -16,304 +16,138 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdbool.h>
-#include <sys/stat.h>
-#include <assert.h>
-#include <mem.h>
 #include <string.h>
+#include <unistd.h>
+#include <mem.h>
+#include "segments.h"
+#include "execute.h"
+#include "load.h"
+#include "cache.h"
+#include "checkpoint.h"
+#include "snapshot.h"
+#include "sample.h"
+#include "counters.h"
 
-const uint32_t REG_A_MASK = 7 << 6;
-const uint32_t REG_B_MASK = 7 << 3;
-const uint32_t REG_C_MASK = 7;
-const uint32_t OP_CODE_MASK = 15UL << 28;
-const uint32_t LOADVAL_VALUE_MASK = (1UL << 25) - 1;
-const uint32_t LOADVAL_REG_A_MASK = 7 << 25;
-
-typedef enum opcode {
-        CMOV = 0, SLOAD, SSTORE, ADD, MULT, DIV, NAND,
-        HALT, MAP, UNMAP, OUTPUT, INPUT, LOADP, LOADV
-} opcode;
-
-typedef struct {
-        uint32_t* data;
-        uint32_t length;
-} *Array_T;
-
-typedef struct {
-        Array_T* mapped;
-        uint32_t mapped_length;
-        Array_T unmapped;
-        uint32_t unmapped_length;
-} *Segment_T;
-
-Array_T new_array(uint32_t length)
-{
-        Array_T array = malloc(sizeof(*array));
-        array->data = malloc(sizeof(uint32_t) * length);
-        array->length = length;
-        return array;
-}
-
-inline void free_array(Array_T* array)
-{
-        free((*array)->data);
-        free(*array);
-}
-
-Segment_T segment_init(uint32_t num_words)
+static void usage(const char* name)
 {
-        Segment_T new_segments = malloc(sizeof(*new_segments));
-        
-        new_segments->mapped = malloc(num_words * 8 * sizeof(Array_T));
-        new_segments->mapped_length = 1;
-        new_segments->unmapped = new_array(num_words * 8);
-        new_segments->unmapped_length = 0;
-        
-        new_segments->mapped[0] = new_array(num_words);
-
-        return new_segments;
+        fprintf(stderr, "usage: %s [--image-cache DIR] [--report-rss] "
+                "[--perf-counters] [--checkpoint FILE [--checkpoint-after N]] "
+                "[--sample FILE [--sample-hz N]] "
+                "{program.um | --restore FILE}\n", name);
+        exit(EXIT_FAILURE);
 }
 
-void segment_deinit(Segment_T segments)
+int main(int argc, char *argv[])
 {
-        for (uint32_t i = 0; i < segments->mapped_length; i++) {
-                Array_T array = segments->mapped[i];
-                if (array != NULL) {
-                        free_array(&array);
+        const char* cache_dir = NULL;
+        const char* checkpoint = NULL;
+        const char* restore = NULL;
+        const char* program = NULL;
+        uint64_t checkpoint_after = UINT64_MAX;
+        const char* sample = NULL;
+        unsigned sample_hz = 997;
+        bool report_rss = false;
+        bool perf_counters = false;
+        for (int i = 1; i < argc; i++) {
+                if (strcmp(argv[i], "--image-cache") == 0 && i + 1 < argc) {
+                        cache_dir = argv[++i];
+                } else if (strcmp(argv[i], "--report-rss") == 0) {
+                        report_rss = true;
+                } else if (strcmp(argv[i], "--perf-counters") == 0) {
+                        perf_counters = true;
+                } else if (strcmp(argv[i], "--checkpoint") == 0 &&
+                           i + 1 < argc) {
+                        checkpoint = argv[++i];
+                } else if (strcmp(argv[i], "--checkpoint-after") == 0 &&
+                           i + 1 < argc) {
+                        checkpoint_after = strtoull(argv[++i], NULL, 0);
+                } else if (strcmp(argv[i], "--sample") == 0 &&
+                           i + 1 < argc) {
+                        sample = argv[++i];
+                } else if (strcmp(argv[i], "--sample-hz") == 0 &&
+                           i + 1 < argc) {
+                        sample_hz = strtoul(argv[++i], NULL, 0);
+                } else if (strcmp(argv[i], "--restore") == 0 &&
+                           i + 1 < argc) {
+                        restore = argv[++i];
+                } else if (program == NULL && argv[i][0] != '-') {
+                        program = argv[i];
+                } else {
+                        usage(argv[0]);
                 }
         }
-
-        free(segments->mapped);
-        free_array(&(segments->unmapped));
-        free(segments);
-}
-
-uint32_t segment_new(Segment_T segments, uint32_t num_words)
-{
-        uint32_t id;
-        if (segments->unmapped_length != 0) {
-                id = segments->unmapped->data[segments->unmapped_length - 1];
-                segments->unmapped_length--;
-        } else {
-                id = segments->mapped_length++;
+        if ((program == NULL) == (restore == NULL) ||
+            (checkpoint == NULL && checkpoint_after != UINT64_MAX) ||
+            sample_hz == 0) {
+                usage(argv[0]);
         }
-
-        segments->mapped[id] = new_array(num_words);
-        memset(segments->mapped[id]->data, 0, sizeof(uint32_t) * num_words);
-        
-        return id;
-}
-
-void segment_free(Segment_T segments, uint32_t segment_id)
-{
-        Array_T array = segments->mapped[segment_id];
-        free_array(&array);
-        segments->mapped[segment_id] = NULL;
-        segments->unmapped->data[segments->unmapped_length++] = segment_id;
-}
-
-inline void segment_store_word(Segment_T segments, uint32_t segment_id,
-                        uint32_t offset, uint32_t value)
-{
-        segments->mapped[segment_id]->data[offset] = value;
-}
-
-inline uint32_t segment_get_word(Segment_T segments, uint32_t segment_id,
-                          uint32_t offset)
-{
-        return segments->mapped[segment_id]->data[offset];
-}
-
-void segment_duplicate(Segment_T segments, uint32_t segment_id)
-{
-        Array_T segment = segments->mapped[0];
-        free_array(&segment);
-
-        Array_T word_array = segments->mapped[segment_id];
-        uint32_t len = word_array->length;
-        Array_T program = new_array(len);
-        
-        memcpy(program->data, word_array->data, sizeof(uint32_t) * len);
-
-        segments->mapped[0] = program;
-}
-
-inline opcode get_opcode(uint32_t word)
-{
-        return (opcode)((word & OP_CODE_MASK) >> 28);
-}
-
-inline uint32_t regA(uint32_t word)
-{
-        return (word & REG_A_MASK) >> 6;
-}
-
-inline uint32_t regB(uint32_t word)
-{
-        return (word & REG_B_MASK) >> 3;
-}
-
-inline uint32_t regC(uint32_t word)
-{
-        return word & REG_C_MASK;
-}
-
-inline void cond_move(uint32_t* regA, uint32_t regB, uint32_t regC)
-{
-        if (regC != 0) {
-             *regA = regB;
+#ifndef UM_SAMPLE
+        if (sample != NULL) {
+                fprintf(stderr, "%s: --sample needs a build with "
+                        "SAMPLE=1\n", argv[0]);
+                return EXIT_FAILURE;
         }
-}
-
-inline void add(uint32_t* regA, uint32_t regB, uint32_t regC)
-{
-        *regA = (uint32_t)(regB + regC);
-}
-
-inline void mult(uint32_t *regA, uint32_t regB, uint32_t regC)
-{
-        *regA = (uint32_t)(regB * regC);
-}
-
-inline void divide(uint32_t *regA, uint32_t regB, uint32_t regC)
-{
-        *regA = (regB / regC);
-}
-
-inline void bit_NAND(uint32_t* regA, uint32_t regB, uint32_t regC)
-{
-        *regA = ~(regB & regC);
-}
-
-inline void output(uint32_t regC)
-{
-        printf("%c", regC);
-}
+#endif
 
-inline void input(uint32_t* regC)
-{
-        uint32_t input = getchar();
-        
-        if (input <= 255) {
-                *regC = input;
+        uint32_t registers[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        uint32_t pc = 0;
+        Segment_T segments;
+        if (restore != NULL) {
+                segments = snapshot_load(restore, 0, registers, &pc);
+                if (segments == NULL) {
+                        fprintf(stderr, "%s: not a UM snapshot\n", restore);
+                        return EXIT_FAILURE;
+                }
         } else {
-                *regC = 0xFFFFFFFF;
+                /* mapping the file and byte-swapping it into segment 0,
+                 * or mapping an already swapped copy */
+                segments = cache_dir == NULL ? load_program(program) :
+                           image_cache_open(cache_dir, program,
+                                            registers, &pc);
+                if (segments == NULL) {
+                        printf("%s: No such file or directory\n", program);
+                        return EXIT_FAILURE;
+                }
+        }
+        if (checkpoint != NULL) {
+                checkpoint_arm(checkpoint, checkpoint_after);
         }
-}
-
-inline uint32_t convert_endian(uint32_t value) {
-        return ((value & 0xFF) << 24) |
-               (((value >> 8) & 0xFF) << 16) |
-               (((value >> 16) & 0xFF) << 8) |
-               ((value >> 24) & 0xFF);
-}
 
-int main(int argc, char *argv[])
-{
-        assert(argc == 2);
+        /* the output file is opened first, so a bad path fails early */
+        FILE* sample_out = NULL;
+        if (sample != NULL) {
+                sample_out = fopen(sample, "w");
+                if (sample_out == NULL || !sample_start(segments, sample_hz)) {
+                        perror(sample);
+                        return EXIT_FAILURE;
+                }
+        }
 
-        /* obtaining file size */
-        struct stat fileStat;
-        size_t fileSize = 0;
-        if (stat(argv[1], &fileStat) == 0) {
-                /* file size in bits */
-                fileSize = fileStat.st_size * 8;
+        segments->io = io_new_fd(STDIN_FILENO, STDOUT_FILENO);
+        uint64_t steps = 0;
+        if (perf_counters && !counters_start()) {
+                perror("perf_event_open");
+                perf_counters = false;
         }
-        
-        /* opening file */
-        FILE* inputFile = fopen(argv[1], "rb");
-        if (inputFile == NULL) {
-                printf("%s: No such file or directory\n", argv[1]);
-                return EXIT_FAILURE;
+        Exec_status status = execute_for(segments, registers, &pc, &steps,
+                                         UINT64_MAX);
+        if (status == EXEC_FAULT) {
+                fprintf(stderr, "%s: invalid instruction or jump at pc %u "
+                        "after %llu instructions\n", argv[0], pc,
+                        (unsigned long long)steps);
         }
-        
-        Segment_T segments = segment_init(fileSize / 32);
-        uint32_t word = 0;
-
-        /* while not EOF, store bits in file as words */
-        static int i = 0;
-        while (fread(&word, sizeof(uint32_t), 1, inputFile) == 1) {
-                segments->mapped[0]->data[i++] = convert_endian(word);
+        if (perf_counters) {
+                counters_report(steps, segments->dispatches, stderr);
         }
-        fclose(inputFile);
-
-        uint32_t registers[8] = {0, 0, 0, 0, 0, 0, 0, 0};
-        uint32_t prog_counter = 0;
-        bool halted = false;
-
-        /* iterate through instructions until a halt is read */
-        while (!halted) {
-                word = segments->mapped[0]->data[prog_counter++];
-                opcode op = get_opcode(word);
-                
-                switch (op) {
-                case LOADV:
-                        registers[(word & LOADVAL_REG_A_MASK) >> 25] = 
-                                                word & LOADVAL_VALUE_MASK;
-                        break;
-                case OUTPUT:
-                        output(registers[regC(word)]);
-                        break;
-                case CMOV:
-                        cond_move(&registers[regA(word)],
-                                   registers[regB(word)],
-                                   registers[regC(word)]);
-                        break;
-                case SLOAD:
-                        registers[regA(word)] = segment_get_word(segments,
-                                                registers[regB(word)],
-                                                registers[regC(word)]);
-                        break;
-                case SSTORE:
-                        segment_store_word(segments, registers[regA(word)],
-                                                     registers[regB(word)],
-                                                     registers[regC(word)]);
-                        break;
-                case NAND:
-                        bit_NAND(&registers[regA(word)],
-                                  registers[regB(word)],
-                                  registers[regC(word)]);
-                        break;
-                case INPUT:
-                        input(&registers[regC(word)]);
-                        break;
-                case ADD:
-                        add(&registers[regA(word)],
-                             registers[regB(word)],
-                             registers[regC(word)]);
-                        break;
-                case MULT:
-                        mult(&registers[regA(word)],
-                              registers[regB(word)],
-                              registers[regC(word)]);
-                        break;
-                case DIV:
-                        divide(&registers[regA(word)],
-                                registers[regB(word)],
-                                registers[regC(word)]);
-                        break;
-                case MAP:
-                        registers[regB(word)] = segment_new(segments,
-                                                registers[regC(word)]);
-                        break;
-                case UNMAP:
-                        segment_free(segments, registers[regC(word)]);
-                        break;
-                case LOADP:
-                        if (registers[regB(word)] != 0) {
-                                segment_duplicate(segments,
-                                                  registers[regB(word)]);
-                        }
-                        prog_counter = registers[regC(word)];
-                        break;
-                case HALT:
-                        halted = true;
-                        break;
-                default:
-                        break;
-                }
+        if (sample_out != NULL) {
+                sample_report(segments, sample_out);
+                fclose(sample_out);
+        }
+        if (report_rss) {
+                snapshot_report(segments, stderr);
         }
 
         segment_deinit(segments);
 
-        return EXIT_SUCCESS;
+        return status == EXEC_FAULT ? EXIT_FAILURE : EXIT_SUCCESS;
 }
@@ -0,0 +1,223 @@
+/**************************************************************
+ *                        um2c.c
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/16/2026
+ *
+ *       Summary:   Ahead-of-time UM-to-C translator. Every word of the
+ *                  image becomes a labelled C statement over locals
+ *                  r0-r7, in one function per 64 words; LOADP becomes
+ *                  a switch over the function's labels, and a jump out
+ *                  of it returns to main, which calls the function for
+ *                  the target. Memory and I/O go through the same
+ *                  segments.h and execute.h code the interpreter uses.
+ *
+ *                  The translation is only valid while segment 0 is the
+ *                  original image. SSTOREs into segment 0 are common
+ *                  (midmark keeps its globals there), so they just mark
+ *                  the word dirty; only executing a dirty word, or a
+ *                  LOADP of another segment, hands the current state to
+ *                  execute() and the run finishes in the interpreter.
+ *                  So does an invalid word, which faults there; the
+ *                  program then exits with status 1, as um does.
+ *
+ *                  Usage: um2c program.um > program.c
+ *
+ **************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include "instructions.h"
+
+/* words per generated function; one function for the whole image takes
+ * the C compiler minutes */
+#define CHUNK 64
+
+static void translate(FILE* out, uint32_t pc, uint32_t word)
+{
+        Instruction ins = decode_word(word);
+        unsigned a = ins.a, b = ins.b, c = ins.c;
+
+        fprintf(out, "L%u: GUARD(%uu); ", pc, pc);
+        switch (ins.op) {
+        case CMOV:
+                fprintf(out, "if (r%u != 0) r%u = r%u;\n", c, a, b);
+                break;
+        case SLOAD:
+                fprintf(out, "r%u = segment_get_word(segments, r%u, r%u);\n",
+                        a, b, c);
+                break;
+        case SSTORE:
+                fprintf(out, "segment_store_word(segments, r%u, r%u, r%u); "
+                        "if (r%u == 0) dirty[r%u] = r%u != image[r%u];\n",
+                        a, b, c, a, b, c, b);
+                break;
+        case ADD:
+                fprintf(out, "r%u = r%u + r%u;\n", a, b, c);
+                break;
+        case MULT:
+                fprintf(out, "r%u = r%u * r%u;\n", a, b, c);
+                break;
+        case DIV:
+                fprintf(out, "r%u = r%u / r%u;\n", a, b, c);
+                break;
+        case NAND:
+                fprintf(out, "r%u = ~(r%u & r%u);\n", a, b, c);
+                break;
+        case HALT:
+                fprintf(out, "goto halt;\n");
+                break;
+        case MAP:
+                fprintf(out, "r%u = segment_new(segments, r%u);\n", b, c);
+                break;
+        case UNMAP:
+                fprintf(out, "segment_free(segments, r%u);\n", c);
+                break;
+        case OUTPUT:
+                fprintf(out, "output(segments->io, r%u);\n", c);
+                break;
+        case INPUT:
+                fprintf(out, "input(segments->io, &r%u);\n", c);
+                break;
+        case LOADP:
+                fprintf(out, "if (r%u != 0) { segment_duplicate(segments, "
+                        "r%u); FALLBACK(r%u); } JUMP(r%u);\n", b, b, c, c);
+                break;
+        case LOADV:
+                fprintf(out, "r%u = %uu;\n", a, ins.value);
+                break;
+        default:
+                /* opcodes 14 and 15: the interpreter faults on them */
+                fprintf(out, "FALLBACK(%uu);\n", pc);
+                break;
+        }
+}
+
+int main(int argc, char *argv[])
+{
+        if (argc != 2) {
+                fprintf(stderr, "usage: %s program.um > program.c\n",
+                        argv[0]);
+                return EXIT_FAILURE;
+        }
+
+        FILE* inputFile = fopen(argv[1], "rb");
+        if (inputFile == NULL) {
+                printf("%s: No such file or directory\n", argv[1]);
+                return EXIT_FAILURE;
+        }
+
+        struct stat fileStat;
+        fstat(fileno(inputFile), &fileStat);
+        uint32_t num_words = fileStat.st_size / 4;
+        uint32_t* image = malloc(sizeof(uint32_t) * (num_words + 1));
+
+        uint32_t word = 0;
+        for (uint32_t i = 0; i < num_words &&
+             fread(&word, sizeof(uint32_t), 1, inputFile) == 1; i++) {
+                image[i] = convert_endian(word);
+        }
+        fclose(inputFile);
+
+        FILE* out = stdout;
+        fprintf(out, "/* translated from %s by um2c */\n\n", argv[1]);
+        fprintf(out, "#include <stdio.h>\n#include <stdlib.h>\n"
+                     "#include <string.h>\n"
+                     "#include \"segments.h\"\n#include \"execute.h\"\n\n");
+
+        fprintf(out, "static const uint32_t image[%u] = {", num_words + 1);
+        for (uint32_t i = 0; i < num_words; i++) {
+                fprintf(out, "%s0x%08x,", i % 8 == 0 ? "\n" : " ", image[i]);
+        }
+        fprintf(out, "\n};\n\n");
+        fprintf(out, "static uint8_t dirty[%u];\n\n", num_words + 1);
+
+        fprintf(out,
+                "enum { IN_CHUNKS, TO_EXECUTE, HALTED };\n\n"
+                "#define JUMP(p) do { prog_counter = (p); goto dispatch; "
+                "} while (0)\n"
+                "#define FALLBACK(p) do { prog_counter = (p); "
+                "result = TO_EXECUTE; goto leave; } while (0)\n"
+                "#define GUARD(p) do { if (__builtin_expect(dirty[p], 0)) "
+                "FALLBACK(p); } while (0)\n\n");
+
+        /* one function per chunk: it runs from 'pc' until control
+         * leaves the chunk, then hands back the pc and registers */
+        uint32_t num_chunks = (num_words + CHUNK - 1) / CHUNK;
+        for (uint32_t chunk = 0; chunk < num_chunks; chunk++) {
+                uint32_t first = chunk * CHUNK;
+                uint32_t end = first + CHUNK < num_words ? first + CHUNK :
+                               num_words;
+                fprintf(out,
+                        "static int chunk%u(uint32_t registers[8], "
+                        "Segment_T segments, uint32_t* pc)\n{\n"
+                        "uint32_t r0 = registers[0], r1 = registers[1], "
+                        "r2 = registers[2], r3 = registers[3];\n"
+                        "uint32_t r4 = registers[4], r5 = registers[5], "
+                        "r6 = registers[6], r7 = registers[7];\n"
+                        "uint32_t prog_counter = *pc;\n"
+                        "int result = IN_CHUNKS;\n\n", chunk);
+
+                fprintf(out, "dispatch:\nswitch (prog_counter) {\n");
+                for (uint32_t pc = first; pc < end; pc++) {
+                        fprintf(out, "case %u: goto L%u;\n", pc, pc);
+                }
+                fprintf(out, "default: goto leave;\n}\n\n");
+
+                for (uint32_t pc = first; pc < end; pc++) {
+                        translate(out, pc, image[pc]);
+                }
+                fprintf(out, "prog_counter = %uu;\ngoto leave;\n"
+                        "halt:\nresult = HALTED;\n", end);
+                fprintf(out,
+                        "leave:\n"
+                        "registers[0] = r0; registers[1] = r1; "
+                        "registers[2] = r2; registers[3] = r3;\n"
+                        "registers[4] = r4; registers[5] = r5; "
+                        "registers[6] = r6; registers[7] = r7;\n"
+                        "*pc = prog_counter;\n"
+                        "return result;\n}\n\n");
+        }
+
+        fprintf(out, "static int (*const chunks[%u])(uint32_t*, Segment_T, "
+                "uint32_t*) = {", num_chunks + 1);
+        for (uint32_t chunk = 0; chunk < num_chunks; chunk++) {
+                fprintf(out, "%schunk%u,", chunk % 8 == 0 ? "\n" : " ",
+                        chunk);
+        }
+        fprintf(out, "\n};\n\n");
+
+        fprintf(out,
+                "int main(void)\n{\n"
+                "uint32_t registers[8] = {0, 0, 0, 0, 0, 0, 0, 0};\n"
+                "uint32_t prog_counter = 0;\n"
+                "Segment_T segments = segment_init(%u);\n"
+                "memcpy(segments->mapped[0], image, "
+                "sizeof(uint32_t) * %u);\n"
+                "decode_program(segments);\n"
+                "segments->io = io_new_fd(0, 1);\n\n"
+                "int result = IN_CHUNKS;\n"
+                "while (result == IN_CHUNKS) {\n"
+                "if (prog_counter >= %uu) {\n"
+                "result = TO_EXECUTE;\n"
+                "break;\n"
+                "}\n"
+                "result = chunks[prog_counter / %u](registers, segments, "
+                "&prog_counter);\n"
+                "}\n"
+                "if (result == TO_EXECUTE && execute(segments, registers, "
+                "prog_counter) == EXEC_FAULT) {\n"
+                "fprintf(stderr, \"invalid instruction or jump\\n\");\n"
+                "segment_deinit(segments);\n"
+                "return EXIT_FAILURE;\n"
+                "}\n"
+                "segment_deinit(segments);\n"
+                "return EXIT_SUCCESS;\n"
+                "}\n", num_words, num_words, num_words, CHUNK);
+
+        free(image);
+        return EXIT_SUCCESS;
+}
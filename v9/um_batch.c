@@ -0,0 +1,255 @@
+/**************************************************************
+ *                        um_batch.c
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   um-batch: runs many UM programs in one process on a
+ *                  fixed pool of worker threads, each with its own
+ *                  machine, and checks their output.
+ *
+ *                  Usage: um-batch [-j workers] manifest
+ *
+ *                  Each manifest line is "program [input [expected]]";
+ *                  "-" or a missing field means no input (end of input
+ *                  at once) or no check. Blank lines and lines starting
+ *                  with '#' are skipped. One result line per program is
+ *                  printed in manifest order; the exit status is 1 if
+ *                  any program failed its check, faulted or couldn't be
+ *                  run.
+ *
+ **************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "segments.h"
+#include "execute.h"
+#include "load.h"
+#include "bench.h"
+
+typedef enum { PASS, FAIL, RAN, ERROR } Status;
+
+typedef struct {
+        char* program;
+        char* input;
+        char* expected;
+        Status status;
+        size_t output_length;
+        double seconds;
+        const char* error;
+} Job;
+
+typedef struct {
+        unsigned char* bytes;
+        size_t length;
+        size_t capacity;
+} Capture;
+
+typedef struct {
+        Job* jobs;
+        size_t num_jobs;
+        size_t next;
+} Queue;
+
+static void capture_write(void* sink, const unsigned char* bytes,
+                          size_t length)
+{
+        Capture* capture = sink;
+        if (capture->length + length > capture->capacity) {
+                size_t capacity = capture->capacity * 2;
+                while (capacity < capture->length + length) {
+                        capacity *= 2;
+                }
+                capture->bytes = realloc(capture->bytes, capacity);
+                capture->capacity = capacity;
+        }
+        memcpy(capture->bytes + capture->length, bytes, length);
+        capture->length += length;
+}
+
+/* whole file, or NULL */
+static unsigned char* read_file(const char* path, size_t* length)
+{
+        FILE* file = fopen(path, "rb");
+        if (file == NULL) {
+                return NULL;
+        }
+        Capture contents = { malloc(4096), 0, 4096 };
+        unsigned char chunk[4096];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+                capture_write(&contents, chunk, n);
+        }
+        fclose(file);
+        *length = contents.length;
+        return contents.bytes;
+}
+
+static void run_job(Job* job)
+{
+        double start = bench_seconds();
+        Segment_T segments = load_program(job->program);
+        if (segments == NULL) {
+                job->status = ERROR;
+                job->error = "can't load program";
+                return;
+        }
+        const char* input = job->input != NULL ? job->input : "/dev/null";
+        int in_fd = open(input, O_RDONLY);
+        if (in_fd < 0) {
+                segment_deinit(segments);
+                job->status = ERROR;
+                job->error = "can't open input";
+                return;
+        }
+
+        Capture output = { malloc(4096), 0, 4096 };
+        segments->io = io_new(io_read_fd, (void*)(intptr_t)in_fd,
+                              capture_write, &output);
+        uint32_t registers[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        Exec_status status = execute(segments, registers, 0);
+        segment_deinit(segments);
+        close(in_fd);
+        job->seconds = bench_seconds() - start;
+        job->output_length = output.length;
+
+        job->status = RAN;
+        if (status == EXEC_FAULT) {
+                job->status = ERROR;
+                job->error = "invalid instruction or jump";
+        } else if (job->expected != NULL) {
+                size_t length;
+                unsigned char* expected = read_file(job->expected, &length);
+                if (expected == NULL) {
+                        job->status = ERROR;
+                        job->error = "can't read expected output";
+                } else {
+                        job->status = length == output.length &&
+                                      memcmp(expected, output.bytes,
+                                             length) == 0 ? PASS : FAIL;
+                }
+                free(expected);
+        }
+        free(output.bytes);
+}
+
+static void* worker(void* argument)
+{
+        Queue* queue = argument;
+        for (;;) {
+                size_t i = __atomic_fetch_add(&queue->next, 1,
+                                              __ATOMIC_RELAXED);
+                if (i >= queue->num_jobs) {
+                        return NULL;
+                }
+                run_job(&queue->jobs[i]);
+        }
+}
+
+/* "-" or nothing: NULL */
+static char* field(char* token)
+{
+        if (token == NULL || strcmp(token, "-") == 0) {
+                return NULL;
+        }
+        return strdup(token);
+}
+
+static Job* read_manifest(FILE* manifest, size_t* num_jobs)
+{
+        size_t capacity = 64;
+        Job* jobs = malloc(sizeof(Job) * capacity);
+        *num_jobs = 0;
+
+        char line[4096];
+        while (fgets(line, sizeof(line), manifest) != NULL) {
+                char* program = strtok(line, " \t\r\n");
+                if (program == NULL || program[0] == '#') {
+                        continue;
+                }
+                if (*num_jobs == capacity) {
+                        capacity *= 2;
+                        jobs = realloc(jobs, sizeof(Job) * capacity);
+                }
+                Job* job = &jobs[(*num_jobs)++];
+                memset(job, 0, sizeof(*job));
+                job->program = strdup(program);
+                job->input = field(strtok(NULL, " \t\r\n"));
+                job->expected = field(strtok(NULL, " \t\r\n"));
+        }
+        return jobs;
+}
+
+int main(int argc, char *argv[])
+{
+        long workers = sysconf(_SC_NPROCESSORS_ONLN);
+        int opt;
+        while ((opt = getopt(argc, argv, "j:")) != -1) {
+                if (opt == 'j') {
+                        workers = atol(optarg);
+                } else {
+                        optind = argc + 1;
+                }
+        }
+        if (optind != argc - 1 || workers < 1) {
+                fprintf(stderr, "usage: %s [-j workers] manifest\n",
+                        argv[0]);
+                return EXIT_FAILURE;
+        }
+        FILE* manifest = strcmp(argv[optind], "-") == 0 ? stdin :
+                         fopen(argv[optind], "r");
+        if (manifest == NULL) {
+                fprintf(stderr, "%s: No such file or directory\n",
+                        argv[optind]);
+                return EXIT_FAILURE;
+        }
+
+        Queue queue = { NULL, 0, 0 };
+        queue.jobs = read_manifest(manifest, &queue.num_jobs);
+        if (manifest != stdin) {
+                fclose(manifest);
+        }
+
+        double start = bench_seconds();
+        pthread_t* threads = malloc(sizeof(pthread_t) * workers);
+        for (long t = 0; t < workers; t++) {
+                pthread_create(&threads[t], NULL, worker, &queue);
+        }
+        for (long t = 0; t < workers; t++) {
+                pthread_join(threads[t], NULL);
+        }
+        double elapsed = bench_seconds() - start;
+        free(threads);
+
+        static const char* const names[] = { "PASS", "FAIL", "RAN", "ERROR" };
+        size_t counts[4] = { 0, 0, 0, 0 };
+        for (size_t i = 0; i < queue.num_jobs; i++) {
+                Job* job = &queue.jobs[i];
+                counts[job->status]++;
+                if (job->status == ERROR) {
+                        printf("%-5s %s: %s\n", names[job->status],
+                               job->program, job->error);
+                } else {
+                        printf("%-5s %s: %zu bytes out, %.1f ms\n",
+                               names[job->status], job->program,
+                               job->output_length, job->seconds * 1e3);
+                }
+                free(job->program);
+                free(job->input);
+                free(job->expected);
+        }
+        printf("%zu passed, %zu failed, %zu unchecked, %zu errors; "
+               "%zu programs in %.3f s on %ld workers\n", counts[PASS],
+               counts[FAIL], counts[RAN], counts[ERROR], queue.num_jobs,
+               elapsed, workers);
+        free(queue.jobs);
+
+        return counts[FAIL] + counts[ERROR] == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,314 @@
+/**************************************************************
+ *                        um_load.c
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   um-load: load generator for um-server. Opens many
+ *                  connections at once and replays a script of input
+ *                  lines on each, as fast as the server answers.
+ *
+ *                  Usage: um-load [-c connections] [-p prompt]
+ *                                 socket script
+ *
+ *                  A line is sent once the program prints its prompt
+ *                  (">: " for advent.umz), and its response time runs
+ *                  until the next prompt, or until the server closes
+ *                  the connection after the last line. After the last
+ *                  line the client shuts down its side. The time from
+ *                  connecting to the first prompt is reported on its
+ *                  own, as startup.
+ *
+ **************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "bench.h"
+
+#define MAX_EVENTS 256
+
+/**************************************************************
+ * The Client struct consists of:
+ *      - fd: its connection, -1 once closed.
+ *      - line: the next script line to send.
+ *      - unsent, unsent_length: what the socket hasn't taken yet of the
+ *        line being sent; the rest goes out on EPOLLOUT.
+ *      - blocked: whether EPOLLOUT is being watched for that.
+ *      - matched: how much of the prompt the latest output ends with.
+ *      - waiting_since: when the pending response was asked for.
+ *      - received: output bytes so far.
+ *************************************************************/
+typedef struct {
+        int fd;
+        size_t line;
+        const char* unsent;
+        size_t unsent_length;
+        bool blocked;
+        size_t matched;
+        double waiting_since;
+        size_t received;
+} Client;
+
+/* response times in seconds */
+typedef struct {
+        double* times;
+        size_t length;
+        size_t capacity;
+} Samples;
+
+static char** lines;
+static size_t num_lines;
+static const char* prompt = ">: ";
+static Samples startup, responses;
+static int epoll_fd;
+
+static void sample(Samples* samples, double seconds)
+{
+        if (samples->length == samples->capacity) {
+                samples->capacity = samples->capacity == 0 ? 1024 :
+                                    2 * samples->capacity;
+                samples->times = realloc(samples->times, sizeof(double) *
+                                         samples->capacity);
+        }
+        samples->times[samples->length++] = seconds;
+}
+
+static int compare(const void* a, const void* b)
+{
+        double x = *(const double*)a, y = *(const double*)b;
+        return (x > y) - (x < y);
+}
+
+static void report(const char* title, Samples* samples)
+{
+        if (samples->length == 0) {
+                printf("%-10s no samples\n", title);
+                return;
+        }
+        qsort(samples->times, samples->length, sizeof(double), compare);
+        double* t = samples->times;
+        size_t n = samples->length;
+        printf("%-10s %zu samples: p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, "
+               "max %.3f ms\n", title, n, t[n / 2] * 1e3,
+               t[n * 90 / 100] * 1e3, t[n * 99 / 100] * 1e3,
+               t[n - 1] * 1e3);
+}
+
+/* send what the socket will take of the current line, and watch for
+ * EPOLLOUT while some of it is left */
+static void flush(Client* c)
+{
+        while (c->unsent_length > 0) {
+                ssize_t n = send(c->fd, c->unsent, c->unsent_length,
+                                 MSG_NOSIGNAL);
+                if (n < 0 && errno == EINTR) {
+                        continue;
+                }
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                        break;
+                }
+                if (n <= 0) {
+                        /* the connection is gone; receive() sees it */
+                        c->unsent_length = 0;
+                        break;
+                }
+                c->unsent += n;
+                c->unsent_length -= n;
+        }
+        bool blocked = c->unsent_length > 0;
+        if (blocked != c->blocked) {
+                struct epoll_event event = {
+                        .events = blocked ? EPOLLIN | EPOLLOUT : EPOLLIN,
+                        .data.ptr = c
+                };
+                epoll_ctl(epoll_fd, EPOLL_CTL_MOD, c->fd, &event);
+                c->blocked = blocked;
+        }
+}
+
+/* the prompt arrived: time the response and send the next line, or
+ * shut down after the last */
+static void prompted(Client* c)
+{
+        double now = bench_seconds();
+        sample(c->line == 0 ? &startup : &responses,
+               now - c->waiting_since);
+        if (c->line == num_lines) {
+                shutdown(c->fd, SHUT_WR);
+                c->waiting_since = 0;
+                return;
+        }
+        c->unsent = lines[c->line++];
+        c->unsent_length = strlen(c->unsent);
+        c->waiting_since = now;
+        flush(c);
+}
+
+/* read what the server sent; false once it closed the connection */
+static bool receive(Client* c)
+{
+        size_t prompt_length = strlen(prompt);
+        unsigned char chunk[65536];
+        for (;;) {
+                ssize_t n = recv(c->fd, chunk, sizeof(chunk), 0);
+                if (n < 0 && errno == EINTR) {
+                        continue;
+                }
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                        return true;
+                }
+                if (n <= 0) {
+                        /* the last response ends when the program halts */
+                        if (c->waiting_since != 0 && c->line == num_lines) {
+                                sample(&responses,
+                                       bench_seconds() - c->waiting_since);
+                        }
+                        return false;
+                }
+                c->received += n;
+                for (ssize_t i = 0; i < n; i++) {
+                        if (chunk[i] == (unsigned char)prompt[c->matched]) {
+                                c->matched++;
+                        } else {
+                                c->matched = chunk[i] ==
+                                             (unsigned char)prompt[0];
+                        }
+                        if (c->matched == prompt_length) {
+                                c->matched = 0;
+                                prompted(c);
+                        }
+                }
+        }
+}
+
+/* script lines, each with its newline */
+static bool read_script(const char* path)
+{
+        FILE* file = fopen(path, "r");
+        if (file == NULL) {
+                return false;
+        }
+        size_t capacity = 64;
+        lines = malloc(sizeof(char*) * capacity);
+        char line[4096];
+        while (fgets(line, sizeof(line), file) != NULL) {
+                if (num_lines == capacity) {
+                        capacity *= 2;
+                        lines = realloc(lines, sizeof(char*) * capacity);
+                }
+                lines[num_lines++] = strdup(line);
+        }
+        fclose(file);
+        return true;
+}
+
+static int connect_to(const char* path)
+{
+        struct sockaddr_un address = { .sun_family = AF_UNIX };
+        if (strlen(path) >= sizeof(address.sun_path)) {
+                return -1;
+        }
+        strcpy(address.sun_path, path);
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0 || connect(fd, (struct sockaddr*)&address,
+                              sizeof(address)) != 0) {
+                if (fd >= 0) {
+                        close(fd);
+                }
+                return -1;
+        }
+        fcntl(fd, F_SETFL, O_NONBLOCK);
+        return fd;
+}
+
+int main(int argc, char *argv[])
+{
+        long connections = 100;
+        int opt;
+        while ((opt = getopt(argc, argv, "c:p:")) != -1) {
+                if (opt == 'c') {
+                        connections = atol(optarg);
+                } else if (opt == 'p') {
+                        prompt = optarg;
+                } else {
+                        optind = argc + 1;
+                }
+        }
+        if (optind != argc - 2 || connections < 1 || prompt[0] == '\0') {
+                fprintf(stderr, "usage: %s [-c connections] [-p prompt] "
+                        "socket script\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+        if (!read_script(argv[optind + 1])) {
+                printf("%s: No such file or directory\n", argv[optind + 1]);
+                return EXIT_FAILURE;
+        }
+
+        epoll_fd = epoll_create1(0);
+        Client* clients = calloc(connections, sizeof(Client));
+        double start = bench_seconds();
+        long open = 0, failed = 0;
+        for (long i = 0; i < connections; i++) {
+                Client* c = &clients[i];
+                c->fd = connect_to(argv[optind]);
+                if (c->fd < 0) {
+                        failed++;
+                        continue;
+                }
+                c->waiting_since = bench_seconds();
+                struct epoll_event event = { .events = EPOLLIN,
+                                             .data.ptr = c };
+                epoll_ctl(epoll_fd, EPOLL_CTL_ADD, c->fd, &event);
+                open++;
+        }
+
+        while (open > 0) {
+                struct epoll_event events[MAX_EVENTS];
+                int n = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+                for (int i = 0; i < n; i++) {
+                        Client* c = events[i].data.ptr;
+                        if (events[i].events & EPOLLOUT) {
+                                flush(c);
+                        }
+                        if (!receive(c)) {
+                                epoll_ctl(epoll_fd, EPOLL_CTL_DEL, c->fd,
+                                          NULL);
+                                close(c->fd);
+                                c->fd = -1;
+                                open--;
+                        }
+                }
+        }
+        double elapsed = bench_seconds() - start;
+
+        size_t least = SIZE_MAX, most = 0, unfinished = 0;
+        for (long i = 0; i < connections; i++) {
+                Client* c = &clients[i];
+                if (c->received < least) {
+                        least = c->received;
+                }
+                if (c->received > most) {
+                        most = c->received;
+                }
+                unfinished += c->line != num_lines;
+        }
+        printf("%ld connections (%ld failed), %zu script lines each, "
+               "%.3f s, %.0f lines/s\n", connections, failed, num_lines,
+               elapsed, responses.length / elapsed);
+        printf("output per connection %zu to %zu bytes; %zu ended before "
+               "the script did\n", least, most, unfinished);
+        report("startup", &startup);
+        report("response", &responses);
+
+        return failed + unfinished == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
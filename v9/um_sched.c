@@ -0,0 +1,309 @@
+/**************************************************************
+ *                        um_sched.c
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   um-sched: many interactive sessions of one UM
+ *                  program on the scheduler (sched.h), to see how many
+ *                  a box can host and how long sessions wait to run.
+ *
+ *                  Usage: um-sched [-j workers] [-n sessions]
+ *                                  [-s slice] [-t think_ms]
+ *                                  {program.um | -r snapshot} [input]
+ *
+ *                  Each session gets 'input' one line at a time, each
+ *                  line 'think_ms' after the session started waiting
+ *                  for it, like someone typing; until then the session
+ *                  is parked. -r starts every session from a snapshot
+ *                  (um --checkpoint), which they share, instead of
+ *                  loading the program into each. All sessions should
+ *                  print the same thing, so their outputs are compared.
+ *
+ **************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "libum.h"
+#include "sched.h"
+#include "bench.h"
+
+/**************************************************************
+ * The Client struct consists of:
+ *      - session: its scheduler session.
+ *      - delivered: input bytes it has been given so far (written by
+ *        the feeder); consumed: how many of those it has read.
+ *      - due/next: when the feeder gives it its next line, and the
+ *        next client waiting on the feeder.
+ *      - digest/output_length: FNV-1a hash and length of its output.
+ *      - status/instructions: how it ended.
+ *************************************************************/
+typedef struct Client {
+        Session_T session;
+        size_t delivered;
+        size_t consumed;
+        uint64_t due;
+        struct Client* next;
+        uint64_t digest;
+        size_t output_length;
+        Um_status status;
+        uint64_t instructions;
+} Client;
+
+/* hands clients their next line once it is due */
+static struct {
+        pthread_mutex_t lock;
+        pthread_cond_t changed;
+        Client* head;
+        Client* tail;
+        bool stopping;
+} feeder = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+static unsigned char* input;
+static size_t input_length;
+static uint64_t think_ns;
+
+static uint64_t now_ns(void)
+{
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (uint64_t)now.tv_sec * 1000000000u + now.tv_nsec;
+}
+
+/* 'c' has read everything delivered: queue it for its next line */
+static void feeder_add(Client* c)
+{
+        pthread_mutex_lock(&feeder.lock);
+        c->due = now_ns() + think_ns;
+        c->next = NULL;
+        if (feeder.tail == NULL) {
+                feeder.head = c;
+        } else {
+                feeder.tail->next = c;
+        }
+        feeder.tail = c;
+        pthread_cond_signal(&feeder.changed);
+        pthread_mutex_unlock(&feeder.lock);
+}
+
+/* clients are queued in order of their due times */
+static void* feeder_main(void* argument)
+{
+        (void)argument;
+        pthread_mutex_lock(&feeder.lock);
+        while (!feeder.stopping) {
+                Client* c = feeder.head;
+                if (c == NULL) {
+                        pthread_cond_wait(&feeder.changed, &feeder.lock);
+                        continue;
+                }
+                if (c->due > now_ns()) {
+                        struct timespec until = {
+                                c->due / 1000000000u, c->due % 1000000000u
+                        };
+                        pthread_cond_timedwait(&feeder.changed, &feeder.lock,
+                                               &until);
+                        continue;
+                }
+                feeder.head = c->next;
+                if (feeder.head == NULL) {
+                        feeder.tail = NULL;
+                }
+                pthread_mutex_unlock(&feeder.lock);
+
+                unsigned char* line = memchr(input + c->delivered, '\n',
+                                             input_length - c->delivered);
+                size_t end = line == NULL ? input_length :
+                             (size_t)(line - input) + 1;
+                __atomic_store_n(&c->delivered, end, __ATOMIC_RELEASE);
+                sched_wake(c->session);
+
+                pthread_mutex_lock(&feeder.lock);
+        }
+        pthread_mutex_unlock(&feeder.lock);
+        return NULL;
+}
+
+static ssize_t client_read(void* source, unsigned char* buffer, size_t size)
+{
+        Client* c = source;
+        size_t delivered = __atomic_load_n(&c->delivered, __ATOMIC_ACQUIRE);
+        if (c->consumed == delivered) {
+                if (delivered == input_length) {
+                        return 0;
+                }
+                feeder_add(c);
+                return UM_WOULD_BLOCK;
+        }
+
+        size_t n = delivered - c->consumed;
+        if (n > size) {
+                n = size;
+        }
+        memcpy(buffer, input + c->consumed, n);
+        c->consumed += n;
+        return n;
+}
+
+static void client_write(void* sink, const unsigned char* bytes,
+                         size_t length)
+{
+        Client* c = sink;
+        for (size_t i = 0; i < length; i++) {
+                c->digest = (c->digest ^ bytes[i]) * 1099511628211ull;
+        }
+        c->output_length += length;
+}
+
+static void client_done(Um_T vm, Um_status status, void* arg)
+{
+        Client* c = arg;
+        c->status = status;
+        c->instructions = um_instructions(vm);
+        um_destroy(vm);
+}
+
+/* whole file, or NULL */
+static unsigned char* read_file(const char* path, size_t* length)
+{
+        FILE* file = fopen(path, "rb");
+        if (file == NULL) {
+                return NULL;
+        }
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        rewind(file);
+        unsigned char* bytes = malloc(size > 0 ? size : 1);
+        *length = fread(bytes, 1, size > 0 ? size : 0, file);
+        fclose(file);
+        return bytes;
+}
+
+static void usage(const char* name)
+{
+        fprintf(stderr, "usage: %s [-j workers] [-n sessions] [-s slice] "
+                "[-t think_ms] {program.um | -r snapshot} [input]\n", name);
+        exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[])
+{
+        long workers = sysconf(_SC_NPROCESSORS_ONLN);
+        long sessions = 100;
+        uint64_t slice = 1000000;
+        double think_ms = 0;
+        const char* snapshot = NULL;
+        int opt;
+        while ((opt = getopt(argc, argv, "j:n:s:t:r:")) != -1) {
+                switch (opt) {
+                case 'j':
+                        workers = atol(optarg);
+                        break;
+                case 'n':
+                        sessions = atol(optarg);
+                        break;
+                case 's':
+                        slice = strtoull(optarg, NULL, 0);
+                        break;
+                case 't':
+                        think_ms = atof(optarg);
+                        break;
+                case 'r':
+                        snapshot = optarg;
+                        break;
+                default:
+                        usage(argv[0]);
+                }
+        }
+        /* the program unless there is a snapshot, then maybe input */
+        int files = snapshot == NULL ? 1 : 0;
+        if (workers < 1 || sessions < 1 || slice < 1 ||
+            argc - optind < files || argc - optind > files + 1) {
+                usage(argv[0]);
+        }
+        think_ns = think_ms * 1e6;
+
+        size_t image_length = 0;
+        unsigned char* image = NULL;
+        if (snapshot == NULL) {
+                image = read_file(argv[optind], &image_length);
+                if (image == NULL) {
+                        printf("%s: No such file or directory\n",
+                               argv[optind]);
+                        return EXIT_FAILURE;
+                }
+                optind++;
+        }
+        if (optind < argc) {
+                input = read_file(argv[optind], &input_length);
+                if (input == NULL) {
+                        printf("%s: No such file or directory\n",
+                               argv[optind]);
+                        return EXIT_FAILURE;
+                }
+        }
+
+        /* due times are CLOCK_MONOTONIC */
+        pthread_t feeder_thread;
+        pthread_condattr_t monotonic;
+        pthread_condattr_init(&monotonic);
+        pthread_condattr_setclock(&monotonic, CLOCK_MONOTONIC);
+        pthread_cond_init(&feeder.changed, &monotonic);
+        pthread_create(&feeder_thread, NULL, feeder_main, NULL);
+
+        double start = bench_seconds();
+        Sched_T sched = sched_new(workers, slice);
+        Client* clients = calloc(sessions, sizeof(Client));
+        for (long i = 0; i < sessions; i++) {
+                Client* c = &clients[i];
+                c->digest = 14695981039346656037ull;
+                Um_T vm = um_create();
+                um_set_io(vm, client_read, c, client_write, c);
+                if (snapshot != NULL ? !um_restore(vm, snapshot) :
+                    !um_load_image(vm, image, image_length)) {
+                        fprintf(stderr, "%s: can't load %s\n", argv[0],
+                                snapshot != NULL ? snapshot : "program");
+                        return EXIT_FAILURE;
+                }
+                c->session = sched_session(sched, vm, client_done, c);
+                sched_wake(c->session);
+        }
+        sched_wait(sched);
+        double elapsed = bench_seconds() - start;
+
+        pthread_mutex_lock(&feeder.lock);
+        feeder.stopping = true;
+        pthread_cond_signal(&feeder.changed);
+        pthread_mutex_unlock(&feeder.lock);
+        pthread_join(feeder_thread, NULL);
+
+        uint64_t instructions = 0;
+        long faults = 0, differ = 0;
+        for (long i = 0; i < sessions; i++) {
+                instructions += clients[i].instructions;
+                faults += clients[i].status == UM_FAULT;
+                differ += clients[i].digest != clients[0].digest ||
+                          clients[i].output_length !=
+                          clients[0].output_length;
+        }
+        printf("%ld sessions on %ld workers: %ld faulted, %ld outputs "
+               "differ from the first (%zu bytes)\n", sessions, workers,
+               faults, differ, clients[0].output_length);
+        printf("%.3f s, %llu instructions, %.1f MIPS\n", elapsed,
+               (unsigned long long)instructions,
+               instructions / elapsed / 1e6);
+        sched_report(sched, stdout);
+
+        sched_free(sched);
+        free(clients);
+        free(image);
+        free(input);
+        return faults + differ == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,471 @@
+/**************************************************************
+ *                        um_server.c
+ *
+ *       Assignment: um
+ *       Authors:    Saajid Islam (mislam08), Laila Ghabbour (lghabb01)
+ *       Date:       10/17/2026
+ *
+ *       Summary:   um-server: serves interactive UM sessions on a Unix
+ *                  domain socket, one machine per connection, all in
+ *                  one process on the scheduler (sched.h).
+ *
+ *                  Usage: um-server [-j workers] [-s slice] [-n count]
+ *                                   {program.um | -r snapshot} socket
+ *
+ *                  Bytes from the connection are the machine's input
+ *                  and its output goes back on the connection. When the
+ *                  client shuts down its side, INPUT sees end of input;
+ *                  when the machine halts, the connection is closed
+ *                  once its output is sent. -n exits after serving that
+ *                  many connections, printing scheduler statistics.
+ *
+ *                  The main thread owns the sockets: an epoll loop over
+ *                  non-blocking fds accepts, reads input into each
+ *                  connection's buffer and wakes its session. Workers
+ *                  send output straight from the write callback while
+ *                  the socket takes it, and leave the rest for the main
+ *                  thread to send on EPOLLOUT. Output is buffered
+ *                  without limit.
+ *
+ **************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "libum.h"
+#include "sched.h"
+
+#define MAX_EVENTS 256
+#define READ_CHUNK 65536
+
+typedef struct {
+        unsigned char* bytes;
+        size_t start;
+        size_t end;
+        size_t capacity;
+} Buffer;
+
+/**************************************************************
+ * The Conn struct consists of:
+ *      - fd, session: the connection and the machine serving it.
+ *      - lock: guards everything below; the main thread and the
+ *        worker running the session both use them.
+ *      - in, in_closed: input not yet read by the machine, and
+ *        whether the client has shut down its side.
+ *      - out, peer_gone: output not yet sent, and whether the client
+ *        is gone (output is dropped from then on).
+ *      - events: what epoll watches the fd for (0: not registered).
+ *      - halted: the machine is done (set by its worker); finished:
+ *        the main thread has seen that, and may close the fd.
+ *************************************************************/
+typedef struct Conn {
+        int fd;
+        Session_T session;
+        pthread_mutex_t lock;
+        Buffer in;
+        bool in_closed;
+        Buffer out;
+        bool peer_gone;
+        uint32_t events;
+        bool halted;
+        bool finished;
+        struct Conn* next_done;
+} Conn;
+
+static int epoll_fd;
+
+/* halted connections for the main thread, signalled through done_fd */
+static int done_fd;
+static pthread_mutex_t done_lock = PTHREAD_MUTEX_INITIALIZER;
+static Conn* done_list;
+
+static void buffer_append(Buffer* b, const unsigned char* bytes,
+                          size_t length)
+{
+        if (b->start == b->end) {
+                b->start = b->end = 0;
+        }
+        if (b->end + length > b->capacity) {
+                memmove(b->bytes, b->bytes + b->start, b->end - b->start);
+                b->end -= b->start;
+                b->start = 0;
+                while (b->end + length > b->capacity) {
+                        b->capacity = b->capacity == 0 ? 4096 :
+                                      2 * b->capacity;
+                }
+                b->bytes = realloc(b->bytes, b->capacity);
+        }
+        memcpy(b->bytes + b->end, bytes, length);
+        b->end += length;
+}
+
+/* epoll interest for c->fd; conn lock held */
+static void watch(Conn* c, uint32_t events)
+{
+        if (events == c->events) {
+                return;
+        }
+        struct epoll_event event = { .events = events, .data.ptr = c };
+        int op = c->events == 0 ? EPOLL_CTL_ADD :
+                 events == 0 ? EPOLL_CTL_DEL : EPOLL_CTL_MOD;
+        epoll_ctl(epoll_fd, op, c->fd, &event);
+        c->events = events;
+}
+
+/* what the main thread waits for on c->fd; conn lock held */
+static void rewatch(Conn* c)
+{
+        uint32_t events = c->in_closed ? 0 : EPOLLIN;
+        if (c->out.start != c->out.end && !c->peer_gone) {
+                events |= EPOLLOUT;
+        }
+        watch(c, events);
+}
+
+/* send as much as the socket takes now; conn lock held */
+static size_t send_some(Conn* c, const unsigned char* bytes, size_t length)
+{
+        size_t sent = 0;
+        while (sent < length) {
+                ssize_t n = send(c->fd, bytes + sent, length - sent,
+                                 MSG_NOSIGNAL | MSG_DONTWAIT);
+                if (n < 0 && errno == EINTR) {
+                        continue;
+                }
+                if (n < 0) {
+                        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                                c->peer_gone = true;
+                        }
+                        break;
+                }
+                sent += n;
+        }
+        return sent;
+}
+
+static ssize_t conn_read(void* source, unsigned char* buffer, size_t size)
+{
+        Conn* c = source;
+        pthread_mutex_lock(&c->lock);
+        ssize_t n;
+        size_t available = c->in.end - c->in.start;
+        if (available == 0) {
+                n = c->in_closed ? 0 : UM_WOULD_BLOCK;
+        } else {
+                n = available < size ? available : size;
+                memcpy(buffer, c->in.bytes + c->in.start, n);
+                c->in.start += n;
+        }
+        pthread_mutex_unlock(&c->lock);
+        return n;
+}
+
+static void conn_write(void* sink, const unsigned char* bytes, size_t length)
+{
+        Conn* c = sink;
+        pthread_mutex_lock(&c->lock);
+        if (!c->peer_gone) {
+                size_t sent = 0;
+                if (c->out.start == c->out.end) {
+                        sent = send_some(c, bytes, length);
+                }
+                if (sent < length && !c->peer_gone) {
+                        buffer_append(&c->out, bytes + sent, length - sent);
+                        rewatch(c);
+                }
+        }
+        pthread_mutex_unlock(&c->lock);
+}
+
+/* on the worker: hand the connection back to the main thread */
+static void conn_done(Um_T vm, Um_status status, void* arg)
+{
+        (void)status;
+        Conn* c = arg;
+        um_destroy(vm);
+
+        pthread_mutex_lock(&c->lock);
+        c->halted = true;
+        pthread_mutex_unlock(&c->lock);
+
+        pthread_mutex_lock(&done_lock);
+        c->next_done = done_list;
+        done_list = c;
+        pthread_mutex_unlock(&done_lock);
+        uint64_t one = 1;
+        if (write(done_fd, &one, sizeof(one)) < 0) {
+                perror("eventfd");
+        }
+}
+
+static void close_conn(Conn* c)
+{
+        watch(c, 0);
+        close(c->fd);
+        free(c->in.bytes);
+        free(c->out.bytes);
+        pthread_mutex_destroy(&c->lock);
+        free(c);
+}
+
+/* main thread: read what the client sent and wake its machine */
+static void receive(Conn* c)
+{
+        unsigned char chunk[READ_CHUNK];
+        for (;;) {
+                ssize_t n = recv(c->fd, chunk, sizeof(chunk), MSG_DONTWAIT);
+                if (n < 0 && errno == EINTR) {
+                        continue;
+                }
+                pthread_mutex_lock(&c->lock);
+                if (n > 0) {
+                        buffer_append(&c->in, chunk, n);
+                } else if (n == 0 || (errno != EAGAIN &&
+                                      errno != EWOULDBLOCK)) {
+                        c->in_closed = true;
+                }
+                if (!c->halted) {
+                        sched_wake(c->session);
+                }
+                pthread_mutex_unlock(&c->lock);
+                if (n <= 0) {
+                        return;
+                }
+        }
+}
+
+/* main thread: handle epoll 'events' for 'c'; true if it was closed */
+static bool conn_event(Conn* c, uint32_t events)
+{
+        if (events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                receive(c);
+        }
+
+        pthread_mutex_lock(&c->lock);
+        if ((events & (EPOLLOUT | EPOLLERR)) && !c->peer_gone) {
+                c->out.start += send_some(c, c->out.bytes + c->out.start,
+                                          c->out.end - c->out.start);
+        }
+        rewatch(c);
+        bool close_now = c->finished &&
+                         (c->out.start == c->out.end || c->peer_gone);
+        pthread_mutex_unlock(&c->lock);
+
+        if (close_now) {
+                close_conn(c);
+        }
+        return close_now;
+}
+
+/* main thread: a session per accepted connection */
+static void accept_all(int listener, Sched_T sched, const void* image,
+                       size_t image_length, const char* snapshot)
+{
+        for (;;) {
+                int fd = accept(listener, NULL, NULL);
+                if (fd < 0) {
+                        return;
+                }
+                fcntl(fd, F_SETFL, O_NONBLOCK);
+                fcntl(fd, F_SETFD, FD_CLOEXEC);
+                Um_T vm = um_create();
+                if (snapshot != NULL ? !um_restore(vm, snapshot) :
+                    !um_load_image(vm, image, image_length)) {
+                        um_destroy(vm);
+                        close(fd);
+                        continue;
+                }
+
+                Conn* c = calloc(1, sizeof(*c));
+                c->fd = fd;
+                pthread_mutex_init(&c->lock, NULL);
+                um_set_io(vm, conn_read, c, conn_write, c);
+                c->session = sched_session(sched, vm, conn_done, c);
+
+                pthread_mutex_lock(&c->lock);
+                rewatch(c);
+                sched_wake(c->session);
+                pthread_mutex_unlock(&c->lock);
+        }
+}
+
+/* main thread: connections whose machines halted; those with all their
+ * output sent are closed now, the rest once it is. Returns how many
+ * were closed. */
+static long reap(void)
+{
+        uint64_t count;
+        if (read(done_fd, &count, sizeof(count)) < 0) {
+                return 0;
+        }
+        pthread_mutex_lock(&done_lock);
+        Conn* c = done_list;
+        done_list = NULL;
+        pthread_mutex_unlock(&done_lock);
+
+        long closed = 0;
+        while (c != NULL) {
+                Conn* next = c->next_done;
+                pthread_mutex_lock(&c->lock);
+                c->finished = true;
+                pthread_mutex_unlock(&c->lock);
+                closed += conn_event(c, 0);
+                c = next;
+        }
+        return closed;
+}
+
+static int listen_on(const char* path)
+{
+        struct sockaddr_un address = { .sun_family = AF_UNIX };
+        if (strlen(path) >= sizeof(address.sun_path)) {
+                return -1;
+        }
+        strcpy(address.sun_path, path);
+        unlink(path);
+
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                        0);
+        if (fd < 0 || bind(fd, (struct sockaddr*)&address,
+                           sizeof(address)) != 0 ||
+            listen(fd, SOMAXCONN) != 0) {
+                return -1;
+        }
+        return fd;
+}
+
+static volatile sig_atomic_t stopping;
+
+static void stop(int signal)
+{
+        (void)signal;
+        stopping = 1;
+}
+
+static void usage(const char* name)
+{
+        fprintf(stderr, "usage: %s [-j workers] [-s slice] [-n count] "
+                "{program.um | -r snapshot} socket\n", name);
+        exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[])
+{
+        long workers = sysconf(_SC_NPROCESSORS_ONLN);
+        uint64_t slice = 1000000;
+        long count = -1;
+        const char* snapshot = NULL;
+        int opt;
+        while ((opt = getopt(argc, argv, "j:s:n:r:")) != -1) {
+                switch (opt) {
+                case 'j':
+                        workers = atol(optarg);
+                        break;
+                case 's':
+                        slice = strtoull(optarg, NULL, 0);
+                        break;
+                case 'n':
+                        count = atol(optarg);
+                        break;
+                case 'r':
+                        snapshot = optarg;
+                        break;
+                default:
+                        usage(argv[0]);
+                }
+        }
+        if (workers < 1 || slice < 1 ||
+            argc - optind != (snapshot == NULL ? 2 : 1)) {
+                usage(argv[0]);
+        }
+
+        unsigned char* image = NULL;
+        size_t image_length = 0;
+        if (snapshot == NULL) {
+                FILE* file = fopen(argv[optind], "rb");
+                if (file == NULL) {
+                        printf("%s: No such file or directory\n",
+                               argv[optind]);
+                        return EXIT_FAILURE;
+                }
+                fseek(file, 0, SEEK_END);
+                long size = ftell(file);
+                rewind(file);
+                image = malloc(size > 0 ? size : 1);
+                image_length = fread(image, 1, size > 0 ? size : 0, file);
+                fclose(file);
+                optind++;
+        } else {
+                /* fail now rather than on every connection */
+                Um_T vm = um_create();
+                bool ok = um_restore(vm, snapshot);
+                um_destroy(vm);
+                if (!ok) {
+                        fprintf(stderr, "%s: not a UM snapshot\n", snapshot);
+                        return EXIT_FAILURE;
+                }
+        }
+
+        const char* path = argv[optind];
+        int listener = listen_on(path);
+        if (listener < 0) {
+                perror(path);
+                return EXIT_FAILURE;
+        }
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        done_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        struct epoll_event event = { .events = EPOLLIN, .data.ptr = NULL };
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listener, &event);
+        event.data.ptr = &done_fd;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, done_fd, &event);
+
+        struct sigaction action = { .sa_handler = stop };
+        sigaction(SIGINT, &action, NULL);
+        sigaction(SIGTERM, &action, NULL);
+
+        Sched_T sched = sched_new(workers, slice);
+        long served = 0;
+        while (!stopping && (count < 0 || served < count)) {
+                struct epoll_event events[MAX_EVENTS];
+                int n = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+                bool halted = false;
+                for (int i = 0; i < n; i++) {
+                        void* source = events[i].data.ptr;
+                        if (source == NULL) {
+                                accept_all(listener, sched, image,
+                                           image_length, snapshot);
+                        } else if (source == &done_fd) {
+                                halted = true;
+                        } else {
+                                served += conn_event(source,
+                                                     events[i].events);
+                        }
+                }
+                /* after the batch, whose events may name these */
+                if (halted) {
+                        served += reap();
+                }
+        }
+
+        unlink(path);
+        printf("served %ld connections\n", served);
+        sched_report(sched, stdout);
+        if (stopping) {
+                /* sessions may still be running */
+                return EXIT_SUCCESS;
+        }
+        sched_free(sched);
+        free(image);
+        return EXIT_SUCCESS;
+}